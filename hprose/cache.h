@@ -0,0 +1,115 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * hprose/cache.h                                         *
+ *                                                        *
+ * hprose client response cache for php-cpp.             *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#ifndef HPROSE_CACHE_H_
+#define HPROSE_CACHE_H_
+
+#include <phpcpp.h>
+#include <list>
+#include <unordered_map>
+#ifdef ZTS
+#include <mutex>
+#endif
+
+namespace Hprose {
+
+    /*
+     * Responses kept by the process between requests, keyed by the
+     * service url and the request as the writer encoded it, so a call
+     * with the same name and arguments finds the earlier response until
+     * its time to live is over. The least recently used responses go
+     * first when the total size passes max_bytes.
+     */
+    class ResponseCache {
+    private:
+        struct Entry {
+            std::string key;
+            std::string response;
+            Clock::time_point expires;
+            inline size_t size() const {
+                return key.size() * 2 + response.size() + sizeof(Entry);
+            }
+        };
+        std::list<Entry> entries;
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        size_t bytes;
+#ifdef ZTS
+        std::mutex mutex;
+#endif
+        void erase(std::list<Entry>::iterator entry) {
+            bytes -= entry->size();
+            index.erase(entry->key);
+            entries.erase(entry);
+        }
+        void shrink(size_t limit) {
+            while (bytes > limit && !entries.empty()) erase(std::prev(entries.end()));
+        }
+    public:
+        size_t max_bytes;
+        ResponseCache() : bytes(0), max_bytes(16 * 1024 * 1024) {}
+        bool get(const std::string &key, std::string &response) {
+#ifdef ZTS
+            std::lock_guard<std::mutex> lock(mutex);
+#endif
+            auto iter = index.find(key);
+            if (iter == index.end()) return false;
+            if (iter->second->expires <= Clock::now()) {
+                erase(iter->second);
+                return false;
+            }
+            entries.splice(entries.begin(), entries, iter->second);
+            response = iter->second->response;
+            return true;
+        }
+        void put(const std::string &key, const std::string &response, int32_t ttl) {
+#ifdef ZTS
+            std::lock_guard<std::mutex> lock(mutex);
+#endif
+            auto iter = index.find(key);
+            if (iter != index.end()) erase(iter->second);
+            Entry entry{ key, response, Clock::now() + std::chrono::milliseconds(ttl) };
+            if (entry.size() > max_bytes) return;
+            shrink(max_bytes - entry.size());
+            bytes += entry.size();
+            entries.push_front(std::move(entry));
+            index.emplace(key, entries.begin());
+        }
+        void resize(size_t max_bytes) {
+#ifdef ZTS
+            std::lock_guard<std::mutex> lock(mutex);
+#endif
+            this->max_bytes = max_bytes;
+            shrink(max_bytes);
+        }
+        void clear() {
+#ifdef ZTS
+            std::lock_guard<std::mutex> lock(mutex);
+#endif
+            shrink(0);
+        }
+    };
+
+    inline ResponseCache &response_cache() {
+        static ResponseCache cache;
+        return cache;
+    }
+}
+
+#endif /* HPROSE_CACHE_H_ */
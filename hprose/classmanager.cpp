@@ -13,7 +13,7 @@
  *                                                        *
  * hprose classmanager class for php-cpp.                 *
  *                                                        *
- * LastModified: Jun 30, 2014                             *
+ * LastModified: Oct 19, 2026                             *
  * Author: Ma Bingyao <andot@hprose.com>                  *
  *                                                        *
 \**********************************************************/
@@ -21,10 +21,17 @@
 #include "classmanager.h"
 
 namespace Hprose {
-    std::map<std::string, std::string> ClassManager::classCache1;
-    std::map<std::string, std::string> ClassManager::classCache2;
 #ifdef ZTS
+    std::shared_ptr<const ClassCache> ClassManager::cache = std::make_shared<ClassCache>();
+    std::atomic<uint32_t> ClassManager::version(0);
     std::mutex ClassManager::mutex;
+    thread_local std::shared_ptr<const ClassCache> ClassManager::local_cache;
+    thread_local uint32_t ClassManager::local_version = 0;
+    thread_local ClassCache ClassManager::resolved;
+    thread_local uint32_t ClassManager::resolved_version = 0;
+#else
+    ClassCache ClassManager::cache;
+    ClassCache ClassManager::resolved;
 #endif
 
 }
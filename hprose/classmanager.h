@@ -13,7 +13,7 @@
  *                                                        *
  * hprose classmanager class for php-cpp.                 *
  *                                                        *
- * LastModified: Oct 21, 2014                             *
+ * LastModified: Oct 19, 2026                             *
  * Author: Ma Bingyao <andot@hprose.com>                  *
  *                                                        *
 \**********************************************************/
@@ -22,48 +22,190 @@
 #define HPROSE_CLASSMANAGER_H_
 
 #include <phpcpp.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include <fstream>
 #ifdef ZTS
 #include <mutex>
+#include <memory>
+#include <atomic>
 #endif
 
 namespace Hprose {
 
+    struct ClassCache {
+        std::unordered_map<std::string, std::string> classes;
+        std::unordered_map<std::string, std::string> aliases;
+    };
+
     class ClassManager: public Php::Base {
     private:
-        static std::map<std::string, std::string> classCache1;
-        static std::map<std::string, std::string> classCache2;
 #ifdef ZTS
+        /*
+         * The registry is an immutable snapshot which register_class
+         * replaces as a whole. Every thread keeps its own copy of the
+         * snapshot pointer and only reloads it when the version changes,
+         * so lookups take no lock.
+         */
+        static std::shared_ptr<const ClassCache> cache;
+        static std::atomic<uint32_t> version;
         static std::mutex mutex;
+        static thread_local std::shared_ptr<const ClassCache> local_cache;
+        static thread_local uint32_t local_version;
+        static const ClassCache &snapshot() {
+            uint32_t v = version.load(std::memory_order_acquire);
+            if (!local_cache || local_version != v) {
+                local_cache = std::atomic_load(&cache);
+                local_version = v;
+            }
+            return *local_cache;
+        }
+#else
+        static ClassCache cache;
+        static const ClassCache &snapshot() {
+            return cache;
+        }
 #endif
-        static std::string _get_alias(const std::string &cls) {
+        /*
+         * Names resolved during the current request, including the
+         * classes synthesized for unknown aliases. PHP drops those
+         * classes at the end of the request, so this is cleared then.
+         */
 #ifdef ZTS
-            std::lock_guard<std::mutex> lock(mutex);
+        static thread_local ClassCache resolved;
+        static thread_local uint32_t resolved_version;
+        static ClassCache &get_resolved() {
+            uint32_t v = version.load(std::memory_order_acquire);
+            if (resolved_version != v) {
+                resolved.classes.clear();
+                resolved.aliases.clear();
+                resolved_version = v;
+            }
+            return resolved;
+        }
+#else
+        static ClassCache resolved;
+        static ClassCache &get_resolved() {
+            return resolved;
+        }
 #endif
-            auto iter = classCache2.find(cls);
-            if (iter != classCache2.end()) {
+        static std::string _get_alias(const std::string &cls) {
+            const ClassCache &c = snapshot();
+            auto iter = c.aliases.find(cls);
+            if (iter != c.aliases.end()) {
                 return iter->second;
             }
             return "";
         }
         static std::string _get_class(const std::string &alias) {
-#ifdef ZTS
-            std::lock_guard<std::mutex> lock(mutex);
-#endif
-            auto iter = classCache1.find(alias);
-            if (iter != classCache1.end()) {
+            const ClassCache &c = snapshot();
+            auto iter = c.classes.find(alias);
+            if (iter != c.classes.end()) {
                 return iter->second;
             }
             return "";
         }
+        /* [A-Za-z_\x80-\xff][A-Za-z0-9_\x80-\xff]* */
+        static bool is_class_name(const std::string &name) {
+            if (name.empty() || (name[0] >= '0' && name[0] <= '9')) return false;
+            for (unsigned char c : name) {
+                if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                      (c >= '0' && c <= '9') || c == '_' || c >= 0x80)) return false;
+            }
+            return true;
+        }
+        static inline bool registered(const ClassCache &c, const std::string &cls, const std::string &alias) {
+            auto iter = c.classes.find(alias);
+            if (iter == c.classes.end() || iter->second != cls) return false;
+            iter = c.aliases.find(cls);
+            return iter != c.aliases.end() && iter->second == alias;
+        }
     public:
-        static void register_class(const std::string &cls, const std::string &alias) {
+        typedef std::vector<std::pair<std::string, std::string>> ClassList;
+        /*
+         * Registers every (class, alias) pair of the list at once, so a
+         * whole class map costs one new snapshot. Pairs which are already
+         * registered change nothing and don't invalidate the caches.
+         */
+        static void register_classes(const ClassList &list) {
 #ifdef ZTS
             std::lock_guard<std::mutex> lock(mutex);
+            std::shared_ptr<ClassCache> next;
+            for (const auto &item : list) {
+                if (registered(next ? *next : *cache, item.first, item.second)) continue;
+                if (!next) next = std::make_shared<ClassCache>(*cache);
+                next->classes[item.second] = item.first;
+                next->aliases[item.first] = item.second;
+            }
+            if (!next) return;
+            std::atomic_store(&cache, std::shared_ptr<const ClassCache>(next));
+            version.fetch_add(1, std::memory_order_release);
+#else
+            for (const auto &item : list) {
+                if (registered(cache, item.first, item.second)) continue;
+                cache.classes[item.second] = item.first;
+                cache.aliases[item.first] = item.second;
+                resolved.classes.erase(item.second);
+                resolved.aliases.erase(item.first);
+            }
 #endif
-            classCache1[alias] = cls;
-            classCache2[cls] = alias;
+        }
+        static void register_class(const std::string &cls, const std::string &alias) {
+            register_classes(ClassList{ std::make_pair(cls, alias) });
+        }
+        /*
+         * Loads the file named by hprose.class_map at module startup.
+         * Every line maps a class to its alias, as "class = alias";
+         * empty lines and lines starting with '#' or ';' are skipped.
+         */
+        static void load_class_map() {
+            std::string filename = Php::ini_get("hprose.class_map");
+            if (filename.empty()) return;
+            std::ifstream file(filename);
+            if (!file) {
+                Php::warning << "hprose.class_map: can't open " << filename << std::flush;
+                return;
+            }
+            std::string line;
+            ClassList list;
+            for (int32_t number = 1; std::getline(file, line); ++number) {
+                size_t start = line.find_first_not_of(" \t\r");
+                if (start == std::string::npos || line[start] == '#' || line[start] == ';') continue;
+                size_t eq = line.find('=', start);
+                std::string cls, alias;
+                if (eq != std::string::npos && eq > start) {
+                    size_t cls_end = line.find_last_not_of(" \t", eq - 1);
+                    size_t alias_start = line.find_first_not_of(" \t\r", eq + 1);
+                    size_t alias_end = line.find_last_not_of(" \t\r");
+                    cls = line.substr(start, cls_end - start + 1);
+                    if (alias_start != std::string::npos) {
+                        alias = line.substr(alias_start, alias_end - alias_start + 1);
+                    }
+                }
+                if (!cls.empty() && cls[0] == '\\') cls.erase(0, 1);
+                std::string plain = cls;
+                std::replace(plain.begin(), plain.end(), '\\', '_');
+                if (!is_class_name(plain) || !is_class_name(alias)) {
+                    Php::warning << "hprose.class_map: malformed line " << number
+                                 << " in " << filename << std::flush;
+                    continue;
+                }
+                list.emplace_back(cls, alias);
+            }
+            register_classes(list);
+        }
+        static void clear_resolved() {
+            ClassCache &r = get_resolved();
+            r.classes.clear();
+            r.aliases.clear();
         }
         static std::string get_alias(const std::string &cls) {
+            ClassCache &r = get_resolved();
+            auto iter = r.aliases.find(cls);
+            if (iter != r.aliases.end()) {
+                return iter->second;
+            }
             std::string alias = _get_alias(cls);
             if (alias.empty()) {
                 alias = cls;
@@ -72,24 +214,42 @@ namespace Hprose {
                     alias[pos] = '_';
                 }
             }
+            r.aliases[cls] = alias;
             return alias;
         }
         static std::string get_class(const std::string &alias) {
+            ClassCache &r = get_resolved();
+            auto iter = r.classes.find(alias);
+            if (iter != r.classes.end()) {
+                return iter->second;
+            }
             std::string cls = _get_class(alias);
-            if (!cls.empty()) return cls;
-            if (!Php::class_exists(alias)) {
-                cls = alias;
-                size_t pos = 0;
-                while ((pos = cls.find('_', pos)) != std::string::npos) {
-                    cls[pos] = '\\';
+            if (cls.empty()) {
+                /*
+                 * The alias comes off the wire, so it must be a plain class
+                 * name before it reaches the autoloaders or eval.
+                 */
+                if (!is_class_name(alias)) {
+                    throw Php::Exception("Illegal class alias: " + alias);
                 }
-                if (Php::class_exists(cls)) {
-                    register_class(cls, alias);
-                    return cls;
+                cls = alias;
+                if (!Php::class_exists(alias)) {
+                    std::string name = alias;
+                    size_t pos = 0;
+                    while ((pos = name.find('_', pos)) != std::string::npos) {
+                        name[pos] = '\\';
+                    }
+                    if (Php::class_exists(name)) {
+                        register_class(name, alias);
+                        cls = name;
+                    }
+                    else {
+                        Php::eval("class " + alias + " { public function __construct() {} }");
+                    }
                 }
-                Php::eval("class " + alias + " { public function __construct() {} }");
             }
-            return alias;
+            get_resolved().classes[alias] = cls;
+            return cls;
         }
         // -----------------------------------------------------------
         // for PHP
@@ -126,6 +286,9 @@ namespace Hprose {
                      Php::ByVal("alias", Php::Type::String)
                  });
         ext.add(std::move(c));
+        ext.add(Php::Ini("hprose.class_map", ""));
+        ext.onStartup(&Hprose::ClassManager::load_class_map);
+        ext.onIdle(&Hprose::ClassManager::clear_resolved);
     }
 
 }
@@ -0,0 +1,315 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * hprose/client.h                                        *
+ *                                                        *
+ * hprose client class for php-cpp.                       *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#ifndef HPROSE_CLIENT_H_
+#define HPROSE_CLIENT_H_
+
+#include <phpcpp.h>
+#include <algorithm>
+#include <unordered_set>
+
+namespace Hprose {
+
+    class Client : public Php::Base {
+    private:
+        std::string url;
+        Endpoint endpoint;
+        int32_t timeout;
+        bool keepalive;
+        FilterChain filters;
+        std::unordered_set<std::string> cached;
+        int32_t ttl;
+    public:
+        Client() : timeout(30000), keepalive(true), ttl(0) {}
+        virtual ~Client() {}
+        void use_service(const std::string &url) {
+            endpoint = Endpoint::parse(url);
+            this->url = url;
+        }
+        std::string encode(const std::string &name, const Php::Value &args, bool byref, bool simple) const {
+            StringStream stream;
+            Writer writer(stream, simple);
+            stream.write(TagCall);
+            writer.writeString(name);
+            if (args.size() > 0 || byref) {
+                writer.reset();
+                writer.writeList(args);
+                if (byref) writer.writeBoolean(true);
+            }
+            stream.write(TagEnd);
+            return std::move(stream.str());
+        }
+        Php::Value decode(const std::string &response, Php::Value &args, bool byref, int32_t mode) const {
+            if (mode == RawWithEndTag) {
+                return response;
+            }
+            if (mode == Raw) {
+                return Php::Value(response.data(), response.empty() ? 0 : (int)response.size() - 1);
+            }
+            StringStream stream(response);
+            Reader reader(stream);
+            Php::Value result;
+            for (;;) {
+                if (stream.available() <= 0) throw Php::Exception("Wrong response: \r\n" + response);
+                char tag = stream.getchar();
+                switch (tag) {
+                    case TagEnd:
+                        return result;
+                    case TagResult:
+                        if (mode == Serialized) {
+                            StringStream raw;
+                            reader.readRaw(raw);
+                            result = Php::Value(raw.str().data(), raw.size());
+                        }
+                        else {
+                            reader.reset();
+                            result = reader.unserialize();
+                        }
+                        break;
+                    case TagArgument: {
+                        reader.reset();
+                        Php::Value list = reader.readList();
+                        if (byref) args = list;
+                        break;
+                    }
+                    case TagError:
+                        reader.reset();
+                        throw Php::Exception(reader.readString().stringValue());
+                    default:
+                        RawReader::unexpectedTag(tag, std::string() + TagResult + TagArgument + TagError + TagEnd);
+                }
+            }
+        }
+        std::string outgoing(std::string request) const {
+            if (url.empty()) throw Php::Exception("The service url is not set");
+            Php::Value context(this);
+            filters.output(request, context);
+            return request;
+        }
+        std::string incoming(std::string response) const {
+            Php::Value context(this);
+            filters.input(response, context);
+            return response;
+        }
+        bool cacheable(const std::string &name) const {
+            if (cached.empty()) return false;
+            std::string key(name);
+            std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+            return cached.count(key) > 0;
+        }
+        inline std::string cache_key(const std::string &request) const {
+            return url + '\0' + request;
+        }
+        /* keeps the filtered response under key unless it is an error */
+        static const std::string &store(const std::string &key, const std::string &response, int32_t ttl) {
+            if (ttl > 0 && !response.empty() && response[0] == TagResult) {
+                response_cache().put(key, response, ttl);
+            }
+            return response;
+        }
+        Php::Value invoke(const std::string &name, Php::Value &args, bool byref = false,
+                          int32_t mode = Normal, bool simple = false) const {
+            Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout);
+            std::string request = encode(name, args, byref, simple);
+            if (!cacheable(name)) {
+                std::string response = send_request(endpoint, outgoing(request), deadline, keepalive);
+                return decode(incoming(response), args, byref, mode);
+            }
+            std::string key = cache_key(request), response;
+            if (!response_cache().get(key, response)) {
+                response = incoming(send_request(endpoint, outgoing(request), deadline, keepalive));
+                store(key, response, ttl);
+            }
+            return decode(response, args, byref, mode);
+        }
+        /*
+         * Starts the call and returns its future at once; the request
+         * goes out while the script waits on this or any other future.
+         * A cached method is answered from the cache, or joins the same
+         * call already running, which keeps its own deadline.
+         */
+        Php::Value invoke_async(const std::string &name, const Php::Value &args,
+                                int32_t mode, bool simple, int32_t timeout) const {
+            Php::Value none;
+            std::string request = encode(name, args, false, simple);
+            std::string key;
+            std::shared_ptr<AsyncCall> call;
+            Scheduler &calls = scheduler();
+            if (cacheable(name)) {
+                std::string response;
+                key = cache_key(request);
+                if (response_cache().get(key, response)) {
+                    return Php::Object("HproseNativeFuture", new Future(decode(response, none, false, mode)));
+                }
+                call = calls.find(key);
+            }
+            if (!call) {
+                Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout);
+                call = std::make_shared<AsyncCall>(endpoint, outgoing(request), deadline, keepalive);
+                calls.add(call, key);
+                calls.step(Clock::now());
+            }
+            Php::Value self(this);
+            int32_t ttl = key.empty() ? 0 : this->ttl;
+            Future::Decoder decoder = [self, key, ttl, mode](const std::string &response) {
+                const Client *client = static_cast<const Client *>(self.implementation());
+                std::string cached;
+                Php::Value none;
+                if (ttl > 0 && response_cache().get(key, cached)) {
+                    return client->decode(cached, none, false, mode);
+                }
+                return client->decode(store(key, client->incoming(response), ttl), none, false, mode);
+            };
+            return Php::Object("HproseNativeFuture", new Future(call, decoder));
+        }
+        // -----------------------------------------------------------
+        // for PHP
+        void __construct(Php::Parameters &params) {
+            if (params.size() > 0 && params[0].size() > 0) {
+                use_service(params[0].stringValue());
+            }
+        }
+        void useService(Php::Parameters &params) {
+            use_service(params[0].stringValue());
+        }
+        Php::Value invoke(Php::Parameters &params) {
+            Php::Value args = params.size() > 1 ? params[1] : Php::Value(Php::Type::Array);
+            bool byref = params.size() > 2 && params[2].boolValue();
+            int32_t mode = params.size() > 3 ? (int32_t)params[3] : Normal;
+            bool simple = params.size() > 4 && params[4].boolValue();
+            Php::Value result = invoke(params[0].stringValue(), args, byref, mode, simple);
+            if (byref && params.size() > 1) params[1] = args;
+            return result;
+        }
+        Php::Value invokeAsync(Php::Parameters &params) {
+            Php::Value args = params.size() > 1 ? params[1] : Php::Value(Php::Type::Array);
+            int32_t mode = params.size() > 2 ? (int32_t)params[2] : Normal;
+            bool simple = params.size() > 3 && params[3].boolValue();
+            int32_t timeout = params.size() > 4 ? (int32_t)params[4] : this->timeout;
+            return invoke_async(params[0].stringValue(), args, mode, simple, timeout);
+        }
+        Php::Value __call(const char *name, Php::Parameters &params) const {
+            Php::Value args(params);
+            return invoke(name, args);
+        }
+        Php::Value getTimeout() const {
+            return timeout;
+        }
+        void setTimeout(Php::Parameters &params) {
+            timeout = params[0];
+        }
+        Php::Value isKeepAlive() const {
+            return keepalive;
+        }
+        void setKeepAlive(Php::Parameters &params) {
+            keepalive = params.size() > 0 ? params[0].boolValue() : true;
+        }
+        /*
+         * Caches the results of the given methods, which must be read
+         * only, for ttl milliseconds in this worker. maxBytes, when
+         * given, bounds the cache that all clients of the worker share.
+         */
+        void setCache(Php::Parameters &params) {
+            cached.clear();
+            for (const auto &iter : params[0]) {
+                std::string name = iter.second.stringValue();
+                std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+                cached.insert(name);
+            }
+            ttl = params.size() > 1 ? (int32_t)params[1] : 1000;
+            if (ttl <= 0) cached.clear();
+            if (params.size() > 2 && (int64_t)params[2] > 0) {
+                response_cache().resize((size_t)(int64_t)params[2]);
+            }
+        }
+        void clearCache() {
+            response_cache().clear();
+        }
+        Php::Value getFilter() const {
+            return filters.get();
+        }
+        void setFilter(Php::Parameters &params) {
+            filters.set(params[0]);
+        }
+        void addFilter(Php::Parameters &params) {
+            filters.add(params[0]);
+        }
+        Php::Value removeFilter(Php::Parameters &params) {
+            return filters.remove(params[0]);
+        }
+    };
+
+    inline void publish_client(Php::Extension &ext) {
+        Php::Class<Client> c("HproseNativeClient");
+        c.method("__construct",
+                 &Hprose::Client::__construct,
+                 { Php::ByVal("url", Php::Type::String, false) })
+         .method("useService",
+                 &Hprose::Client::useService,
+                 { Php::ByVal("url", Php::Type::String) })
+         .method("invoke",
+                 &Hprose::Client::invoke,
+                 {
+                     Php::ByVal("name", Php::Type::String),
+                     Php::ByRef("args", Php::Type::Array, false),
+                     Php::ByVal("byRef", Php::Type::Bool, false),
+                     Php::ByVal("resultMode", Php::Type::Numeric, false),
+                     Php::ByVal("simple", Php::Type::Bool, false)
+                 })
+         .method("invokeAsync",
+                 &Hprose::Client::invokeAsync,
+                 {
+                     Php::ByVal("name", Php::Type::String),
+                     Php::ByVal("args", Php::Type::Array, false),
+                     Php::ByVal("resultMode", Php::Type::Numeric, false),
+                     Php::ByVal("simple", Php::Type::Bool, false),
+                     Php::ByVal("timeout", Php::Type::Numeric, false)
+                 })
+         .method("getTimeout", &Hprose::Client::getTimeout)
+         .method("setTimeout",
+                 &Hprose::Client::setTimeout,
+                 { Php::ByVal("timeout", Php::Type::Numeric) })
+         .method("isKeepAlive", &Hprose::Client::isKeepAlive)
+         .method("setKeepAlive",
+                 &Hprose::Client::setKeepAlive,
+                 { Php::ByVal("keepAlive", Php::Type::Bool, false) })
+         .method("setCache",
+                 &Hprose::Client::setCache,
+                 {
+                     Php::ByVal("methods", Php::Type::Array),
+                     Php::ByVal("ttl", Php::Type::Numeric, false),
+                     Php::ByVal("maxBytes", Php::Type::Numeric, false)
+                 })
+         .method("clearCache", &Hprose::Client::clearCache)
+         .method("getFilter", &Hprose::Client::getFilter)
+         .method("setFilter",
+                 &Hprose::Client::setFilter,
+                 { Php::ByVal("filter", Php::Type::Null) })
+         .method("addFilter",
+                 &Hprose::Client::addFilter,
+                 { Php::ByVal("filter", Php::Type::Object) })
+         .method("removeFilter",
+                 &Hprose::Client::removeFilter,
+                 { Php::ByVal("filter", Php::Type::Object) });
+        ext.add(std::move(c));
+    }
+}
+
+#endif /* HPROSE_CLIENT_H_ */
@@ -0,0 +1,226 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * hprose/compressfilter.h                                *
+ *                                                        *
+ * hprose compression filters for php-cpp.                *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#ifndef HPROSE_COMPRESSFILTER_H_
+#define HPROSE_COMPRESSFILTER_H_
+
+#include <phpcpp.h>
+#ifdef HPROSE_WITH_LZ4
+#include <lz4.h>
+#endif
+#ifdef HPROSE_WITH_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
+
+namespace Hprose {
+
+    /*
+     * The largest message a compression filter unpacks, from the
+     * hprose.max_message_size setting. The sizes in the compressed data
+     * are checked against it before anything is allocated.
+     */
+    inline uint64_t max_message_size() {
+        int64_t size = Php::ini_get("hprose.max_message_size").numericValue();
+        return size > 0 ? (uint64_t)size : 0;
+    }
+
+#ifdef HPROSE_WITH_LZ4
+    /*
+     * LZ4 block format, prefixed with the original length as four bytes
+     * in little endian order. With a dictionary, both sides must use the
+     * same one.
+     */
+    class LZ4Filter : public NativeFilter {
+    private:
+        std::string dictionary;
+        std::string buffer;
+        LZ4_stream_t *stream;
+    public:
+        LZ4Filter() : stream(nullptr) {}
+        virtual ~LZ4Filter() {
+            if (stream) LZ4_freeStream(stream);
+        }
+        virtual void output(std::string &data) override {
+            int32_t size = (int32_t)data.size();
+            if (size > LZ4_MAX_INPUT_SIZE) throw Php::Exception("data too large to compress");
+            buffer.resize(4 + LZ4_compressBound(size));
+            for (int32_t i = 0; i < 4; ++i) buffer[i] = (char)(size >> (i * 8));
+            int32_t n;
+            if (dictionary.empty()) {
+                n = LZ4_compress_default(data.data(), &buffer[4], size, (int32_t)buffer.size() - 4);
+            }
+            else {
+                if (!stream) stream = LZ4_createStream();
+                LZ4_loadDict(stream, dictionary.data(), (int32_t)dictionary.size());
+                n = LZ4_compress_fast_continue(stream, data.data(), &buffer[4], size,
+                                               (int32_t)buffer.size() - 4, 1);
+            }
+            if (n <= 0) throw Php::Exception("lz4 compression failed");
+            buffer.resize(4 + n);
+            data.swap(buffer);
+        }
+        virtual void input(std::string &data) override {
+            int32_t length = (int32_t)data.size() - 4;
+            if (length < 0) throw Php::Exception("incorrect lz4 data");
+            uint32_t size = 0;
+            for (int32_t i = 0; i < 4; ++i) size |= (uint32_t)(unsigned char)data[i] << (i * 8);
+            /* lz4 can't expand a block more than 255 times */
+            if (size > LZ4_MAX_INPUT_SIZE || size > (uint64_t)length * 255) {
+                throw Php::Exception("incorrect lz4 data");
+            }
+            if (size > max_message_size()) throw Php::Exception("message too large");
+            buffer.resize(size);
+            int32_t n = dictionary.empty() ?
+                        LZ4_decompress_safe(&data[4], &buffer[0], length, (int32_t)size) :
+                        LZ4_decompress_safe_usingDict(&data[4], &buffer[0], length, (int32_t)size,
+                                                      dictionary.data(), (int32_t)dictionary.size());
+            if (n != (int32_t)size) throw Php::Exception("incorrect lz4 data");
+            data.swap(buffer);
+        }
+        // -----------------------------------------------------------
+        // for PHP
+        void __construct(Php::Parameters &params) {
+            if (params.size() > 0 && !params[0].isNull()) {
+                if (!params[0].isString()) throw Php::Exception("dictionary must be a string");
+                dictionary = params[0].stringValue();
+            }
+        }
+    };
+#endif
+
+#ifdef HPROSE_WITH_ZSTD
+    /*
+     * Plain zstd frames, which carry their own content size. A trained
+     * dictionary (see trainDictionary) helps most with small messages,
+     * whose class headers and map keys repeat from one to the next.
+     */
+    class ZstdFilter : public NativeFilter {
+    private:
+        int32_t level;
+        std::string buffer;
+        ZSTD_CCtx *cctx;
+        ZSTD_DCtx *dctx;
+        ZSTD_CDict *cdict;
+        ZSTD_DDict *ddict;
+        static size_t check(size_t result) {
+            if (ZSTD_isError(result)) throw Php::Exception(ZSTD_getErrorName(result));
+            return result;
+        }
+    public:
+        ZstdFilter() : level(3), cctx(nullptr), dctx(nullptr), cdict(nullptr), ddict(nullptr) {}
+        virtual ~ZstdFilter() {
+            if (cctx) ZSTD_freeCCtx(cctx);
+            if (dctx) ZSTD_freeDCtx(dctx);
+            if (cdict) ZSTD_freeCDict(cdict);
+            if (ddict) ZSTD_freeDDict(ddict);
+        }
+        virtual void output(std::string &data) override {
+            if (!cctx) cctx = ZSTD_createCCtx();
+            buffer.resize(ZSTD_compressBound(data.size()));
+            size_t n = cdict ?
+                       ZSTD_compress_usingCDict(cctx, &buffer[0], buffer.size(),
+                                                data.data(), data.size(), cdict) :
+                       ZSTD_compressCCtx(cctx, &buffer[0], buffer.size(),
+                                         data.data(), data.size(), level);
+            buffer.resize(check(n));
+            data.swap(buffer);
+        }
+        virtual void input(std::string &data) override {
+            unsigned long long size = ZSTD_getFrameContentSize(data.data(), data.size());
+            if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN ||
+                size > INT32_MAX) {
+                throw Php::Exception("incorrect zstd data");
+            }
+            if (size > max_message_size()) throw Php::Exception("message too large");
+            if (!dctx) dctx = ZSTD_createDCtx();
+            buffer.resize((size_t)size);
+            size_t n = ddict ?
+                       ZSTD_decompress_usingDDict(dctx, &buffer[0], buffer.size(),
+                                                  data.data(), data.size(), ddict) :
+                       ZSTD_decompressDCtx(dctx, &buffer[0], buffer.size(),
+                                           data.data(), data.size());
+            if (check(n) != size) throw Php::Exception("incorrect zstd data");
+            data.swap(buffer);
+        }
+        // -----------------------------------------------------------
+        // for PHP
+        void __construct(Php::Parameters &params) {
+            if (params.size() > 0) level = params[0];
+            if (params.size() > 1 && !params[1].isNull()) {
+                Php::Value &dictionary = params[1];
+                if (!dictionary.isString()) throw Php::Exception("dictionary must be a string");
+                if (dictionary.size() == 0) return;
+                cdict = ZSTD_createCDict(dictionary.rawValue(), dictionary.size(), level);
+                ddict = ZSTD_createDDict(dictionary.rawValue(), dictionary.size());
+                if (!cdict || !ddict) throw Php::Exception("incorrect zstd dictionary");
+            }
+        }
+        static Php::Value trainDictionary(Php::Parameters &params) {
+            Php::Value &samples = params[0];
+            int32_t capacity = params.size() > 1 ? (int32_t)params[1] : 16384;
+            std::string data;
+            std::vector<size_t> sizes;
+            for (const auto &iter : samples) {
+                const Php::Value &sample = iter.second;
+                if (!sample.isString()) throw Php::Exception("samples must be strings");
+                data.append(sample.rawValue(), sample.size());
+                sizes.push_back(sample.size());
+            }
+            std::string dictionary(capacity, '\0');
+            size_t n = ZDICT_trainFromBuffer(&dictionary[0], dictionary.size(),
+                                             data.data(), sizes.data(), (unsigned)sizes.size());
+            if (ZDICT_isError(n)) throw Php::Exception(ZDICT_getErrorName(n));
+            dictionary.resize(n);
+            return dictionary;
+        }
+    };
+#endif
+
+    inline void publish_compressfilter(Php::Extension &ext, const Php::Interface &filter) {
+        ext.add(Php::Ini("hprose.max_message_size", 16 * 1024 * 1024));
+#ifdef HPROSE_WITH_LZ4
+        Php::Class<LZ4Filter> lz4("HproseLZ4Filter");
+        lz4.method("__construct",
+                   &Hprose::LZ4Filter::__construct,
+                   { Php::ByVal("dictionary", Php::Type::String, false) });
+        ext.add(std::move(native_filter_methods(lz4, filter)));
+#endif
+#ifdef HPROSE_WITH_ZSTD
+        Php::Class<ZstdFilter> zstd("HproseZstdFilter");
+        zstd.method("__construct",
+                    &Hprose::ZstdFilter::__construct,
+                    {
+                        Php::ByVal("level", Php::Type::Numeric, false),
+                        Php::ByVal("dictionary", Php::Type::String, false)
+                    })
+            .method("trainDictionary",
+                    &Hprose::ZstdFilter::trainDictionary,
+                    Php::Static | Php::Public,
+                    {
+                        Php::ByVal("samples", Php::Type::Array),
+                        Php::ByVal("size", Php::Type::Numeric, false)
+                    });
+        ext.add(std::move(native_filter_methods(zstd, filter)));
+#endif
+    }
+}
+
+#endif /* HPROSE_COMPRESSFILTER_H_ */
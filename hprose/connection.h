@@ -0,0 +1,566 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * hprose/connection.h                                    *
+ *                                                        *
+ * hprose client connections for php-cpp.                 *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#ifndef HPROSE_CONNECTION_H_
+#define HPROSE_CONNECTION_H_
+
+#include <phpcpp.h>
+#include <unordered_map>
+#include <chrono>
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#ifdef ZTS
+#include <mutex>
+#endif
+
+namespace Hprose {
+
+    typedef std::chrono::steady_clock Clock;
+
+    /*
+     * Where a client sends its requests: http://host[:port][/path] for
+     * HTTP/1.1, or tcp://host:port for the hprose TCP framing, where
+     * each message is prefixed with its length as 4 big endian bytes.
+     */
+    struct Endpoint {
+        bool http;
+        std::string host;
+        std::string port;
+        std::string path;
+        inline std::string key() const {
+            return (http ? "http://" : "tcp://") + host + ":" + port;
+        }
+        static Endpoint parse(const std::string &url) {
+            Endpoint endpoint;
+            size_t pos = url.find("://");
+            std::string scheme = (pos == std::string::npos ? "" : url.substr(0, pos));
+            if (scheme == "http") {
+                endpoint.http = true;
+            }
+            else if (scheme == "tcp" || scheme == "tcp4" || scheme == "tcp6") {
+                endpoint.http = false;
+            }
+            else {
+                throw Php::Exception("Unsupported url: " + url);
+            }
+            pos += 3;
+            size_t end = url.find('/', pos);
+            std::string authority = url.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+            endpoint.path = (end == std::string::npos ? "/" : url.substr(end));
+            size_t colon = authority.rfind(':');
+            if (!authority.empty() && authority[0] == '[') {
+                size_t bracket = authority.find(']');
+                if (bracket == std::string::npos) throw Php::Exception("Unsupported url: " + url);
+                endpoint.host = authority.substr(1, bracket - 1);
+                colon = (bracket + 1 < authority.size() && authority[bracket + 1] == ':') ?
+                        bracket + 1 : std::string::npos;
+            }
+            else {
+                endpoint.host = authority.substr(0, colon);
+            }
+            if (colon != std::string::npos) {
+                endpoint.port = authority.substr(colon + 1);
+            }
+            else if (endpoint.http) {
+                endpoint.port = "80";
+            }
+            else {
+                throw Php::Exception("Missing port in url: " + url);
+            }
+            return endpoint;
+        }
+    };
+
+    /*
+     * A non-blocking socket whose reads and writes wait with poll until
+     * the deadline of the current request.
+     */
+    class Connection {
+    private:
+        int fd;
+        bool reused;
+        /* a non-blocking socket for ai, pending while the connect is in progress */
+        static int attempt(const struct addrinfo *ai, bool &pending) {
+            int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) return -1;
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+#ifdef SO_NOSIGPIPE
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+            pending = false;
+            if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) return fd;
+            if (errno == EINPROGRESS) {
+                pending = true;
+                return fd;
+            }
+            ::close(fd);
+            return -1;
+        }
+        static struct addrinfo *resolve(const Endpoint &endpoint) {
+            struct addrinfo hints, *list;
+            memset(&hints, 0, sizeof(hints));
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            int error = getaddrinfo(endpoint.host.c_str(), endpoint.port.c_str(), &hints, &list);
+            if (error) throw Php::Exception(endpoint.host + ": " + gai_strerror(error));
+            return list;
+        }
+    public:
+        Connection(int fd = -1, bool reused = false) : fd(fd), reused(reused) {}
+        /* milliseconds left until deadline, as a poll timeout */
+        static int remaining(const Clock::time_point &deadline) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+            return left.count() > 0 ? (int)left.count() : 0;
+        }
+        inline int handle() const {
+            return fd;
+        }
+        inline bool is_reused() const {
+            return reused;
+        }
+        void close() {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+        /* the pending error of a connect that has finished, 0 on success */
+        int error() const {
+            int error = 0;
+            socklen_t len = sizeof(error);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len);
+            return error;
+        }
+        void wait(short events, const Clock::time_point &deadline) {
+            struct pollfd p = { fd, events, 0 };
+            for (;;) {
+                int n = ::poll(&p, 1, remaining(deadline));
+                if (n > 0) return;
+                if (n == 0) throw Php::Exception("Request timeout");
+                if (errno != EINTR) throw Php::Exception(strerror(errno));
+            }
+        }
+        static Connection open(const Endpoint &endpoint, const Clock::time_point &deadline) {
+            struct addrinfo *list = resolve(endpoint);
+            std::string message = "Can't connect to " + endpoint.key();
+            for (struct addrinfo *ai = list; ai; ai = ai->ai_next) {
+                bool pending;
+                Connection conn(attempt(ai, pending));
+                if (conn.handle() < 0) continue;
+                if (pending) {
+                    try {
+                        conn.wait(POLLOUT, deadline);
+                    }
+                    catch (Php::Exception &) {
+                        conn.close();
+                        freeaddrinfo(list);
+                        throw;
+                    }
+                    int error = conn.error();
+                    if (error != 0) {
+                        message += std::string(": ") + strerror(error);
+                        conn.close();
+                        continue;
+                    }
+                }
+                freeaddrinfo(list);
+                return conn;
+            }
+            freeaddrinfo(list);
+            throw Php::Exception(message);
+        }
+        /*
+         * Starts connecting to the first address that takes a socket and
+         * returns at once; pending tells whether the connection must be
+         * polled for POLLOUT and checked with error() before use.
+         */
+        static Connection start(const Endpoint &endpoint, bool &pending) {
+            struct addrinfo *list = resolve(endpoint);
+            for (struct addrinfo *ai = list; ai; ai = ai->ai_next) {
+                Connection conn(attempt(ai, pending));
+                if (conn.handle() < 0) continue;
+                freeaddrinfo(list);
+                return conn;
+            }
+            freeaddrinfo(list);
+            throw Php::Exception("Can't connect to " + endpoint.key() + ": " + strerror(errno));
+        }
+        /* false when the peer has closed the connection */
+        bool send(const char *data, size_t length, const Clock::time_point &deadline) {
+#ifdef MSG_NOSIGNAL
+            const int flags = MSG_NOSIGNAL;
+#else
+            const int flags = 0;
+#endif
+            while (length > 0) {
+                ssize_t n = ::send(fd, data, length, flags);
+                if (n > 0) {
+                    data += n;
+                    length -= n;
+                }
+                else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    wait(POLLOUT, deadline);
+                }
+                else if (errno == EPIPE || errno == ECONNRESET) {
+                    return false;
+                }
+                else if (errno != EINTR) {
+                    throw Php::Exception(strerror(errno));
+                }
+            }
+            return true;
+        }
+        /* appends what is available to buffer, returns 0 at the end */
+        size_t receive(std::string &buffer, const Clock::time_point &deadline) {
+            char chunk[16384];
+            for (;;) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n > 0) {
+                    buffer.append(chunk, n);
+                    return n;
+                }
+                if (n == 0 || errno == ECONNRESET) return 0;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    wait(POLLIN, deadline);
+                }
+                else if (errno != EINTR) {
+                    throw Php::Exception(strerror(errno));
+                }
+            }
+        }
+        /* an idle connection is still usable if it has nothing to read */
+        bool alive() const {
+            struct pollfd p = { fd, POLLIN, 0 };
+            return ::poll(&p, 1, 0) == 0;
+        }
+    };
+
+    /*
+     * Idle connections kept by the process between requests, so a PHP
+     * worker reuses its keep-alive connections across the requests it
+     * serves.
+     */
+    class ConnectionPool {
+    private:
+        struct Idle {
+            int fd;
+            Clock::time_point since;
+        };
+        std::unordered_map<std::string, std::vector<Idle>> idle;
+#ifdef ZTS
+        std::mutex mutex;
+#endif
+    public:
+        size_t max_idle;
+        std::chrono::seconds max_idle_time;
+        ConnectionPool() : max_idle(16), max_idle_time(30) {}
+        ~ConnectionPool() {
+            for (auto &iter : idle) {
+                for (Idle &conn : iter.second) ::close(conn.fd);
+            }
+        }
+        /* an idle connection to endpoint that is still usable, if any */
+        Connection take(const Endpoint &endpoint) {
+#ifdef ZTS
+            std::lock_guard<std::mutex> lock(mutex);
+#endif
+            std::vector<Idle> &list = idle[endpoint.key()];
+            while (!list.empty()) {
+                Idle conn = list.back();
+                list.pop_back();
+                Connection connection(conn.fd, true);
+                if (Clock::now() - conn.since < max_idle_time && connection.alive()) {
+                    return connection;
+                }
+                connection.close();
+            }
+            return Connection();
+        }
+        Connection acquire(const Endpoint &endpoint, const Clock::time_point &deadline) {
+            Connection connection = take(endpoint);
+            if (connection.handle() >= 0) return connection;
+            return Connection::open(endpoint, deadline);
+        }
+        void release(const Endpoint &endpoint, Connection &connection) {
+            if (connection.handle() < 0) return;
+            {
+#ifdef ZTS
+                std::lock_guard<std::mutex> lock(mutex);
+#endif
+                std::vector<Idle> &list = idle[endpoint.key()];
+                if (list.size() < max_idle) {
+                    list.push_back(Idle{ connection.handle(), Clock::now() });
+                    return;
+                }
+            }
+            connection.close();
+        }
+    };
+
+    inline ConnectionPool &connection_pool() {
+        static ConnectionPool pool;
+        return pool;
+    }
+
+    /* body with the HTTP request head or the TCP length prefix before it */
+    inline std::string frame_request(const Endpoint &endpoint, const std::string &body) {
+        std::string request;
+        request.reserve(body.size() + 256);
+        size_t length = body.size();
+        if (endpoint.http) {
+            request.append("POST ").append(endpoint.path).append(" HTTP/1.1\r\n").append("Host: ");
+            /* an IPv6 literal goes in brackets, as in the url */
+            if (endpoint.host.find(':') != std::string::npos) {
+                request.append("[").append(endpoint.host).append("]");
+            }
+            else {
+                request.append(endpoint.host);
+            }
+            if (endpoint.port != "80") request.append(":").append(endpoint.port);
+            request.append("\r\nConnection: keep-alive\r\n")
+                   .append("Content-Type: application/hprose\r\n")
+                   .append("Content-Length: ").append(std::to_string(length))
+                   .append("\r\n\r\n");
+        }
+        else {
+            request.append(1, (char)(length >> 24)).append(1, (char)(length >> 16))
+                   .append(1, (char)(length >> 8)).append(1, (char)length);
+        }
+        request.append(body);
+        return request;
+    }
+
+    /*
+     * Looks for a whole response in what has been received so far and
+     * returns false while it is incomplete, so a caller can go on
+     * receiving whenever its socket is readable. The parser remembers
+     * how far it got, so every call only looks at the new bytes. eof
+     * means the peer has closed the connection and nothing more will
+     * come.
+     */
+    class ResponseParser {
+    private:
+        bool http;
+        bool head;
+        bool chunked;
+        bool last;
+        int64_t length;
+        bool keep;
+        /* where parsing goes on in the buffer */
+        size_t pos;
+        std::string body;
+        static bool incomplete(bool eof) {
+            if (eof) throw Php::Exception("Connection closed before the response ended");
+            return false;
+        }
+        bool readHead(const std::string &buffer, bool eof) {
+            size_t end = buffer.find("\r\n\r\n", pos);
+            if (end == std::string::npos) {
+                pos = buffer.size() > 3 ? buffer.size() - 3 : 0;
+                return incomplete(eof);
+            }
+            size_t head_end = end;
+            end = buffer.find("\r\n");
+            std::string status = buffer.substr(0, end);
+            pos = end + 2;
+            if (status.compare(0, 5, "HTTP/") != 0 || status.size() < 12) {
+                throw Php::Exception("Wrong response: " + status);
+            }
+            keep = (status.compare(0, 8, "HTTP/1.0") != 0);
+            if (status.compare(9, 3, "200") != 0) {
+                throw Php::Exception(status.substr(9));
+            }
+            while (pos < head_end + 2) {
+                end = buffer.find("\r\n", pos);
+                std::string header = buffer.substr(pos, end - pos);
+                pos = end + 2;
+                size_t colon = header.find(':');
+                if (colon == std::string::npos) continue;
+                std::string name = header.substr(0, colon);
+                size_t start = header.find_first_not_of(" \t", colon + 1);
+                std::string value = (start == std::string::npos ? "" : header.substr(start));
+                if (strcasecmp(name.c_str(), "Content-Length") == 0) {
+                    length = strtoll(value.c_str(), nullptr, 10);
+                }
+                else if (strcasecmp(name.c_str(), "Transfer-Encoding") == 0) {
+                    chunked = (strcasecmp(value.c_str(), "chunked") == 0);
+                }
+                else if (strcasecmp(name.c_str(), "Connection") == 0) {
+                    if (strcasecmp(value.c_str(), "close") == 0) keep = false;
+                    else if (strcasecmp(value.c_str(), "keep-alive") == 0) keep = true;
+                }
+            }
+            pos = head_end + 4;
+            head = true;
+            return true;
+        }
+        /* the hex size of the chunk line in [pos, end), with an optional ;extension */
+        size_t chunkSize(const std::string &buffer, size_t end) const {
+            size_t size = 0, i = pos;
+            for (; i < end && isxdigit((unsigned char)buffer[i]); ++i) {
+                if (size > (SIZE_MAX >> 8)) throw Php::Exception("Wrong chunk size");
+                char c = buffer[i];
+                size = size * 16 + (c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+            }
+            if (i == pos) throw Php::Exception("Wrong chunk size");
+            while (i < end && (buffer[i] == ' ' || buffer[i] == '\t')) ++i;
+            if (i < end && buffer[i] != ';') throw Php::Exception("Wrong chunk size");
+            return size;
+        }
+        /* decodes the chunks which are complete, keeping what it has got */
+        bool readChunks(const std::string &buffer, bool eof) {
+            size_t end;
+            while (!last) {
+                end = buffer.find("\r\n", pos);
+                if (end == std::string::npos) return incomplete(eof);
+                size_t size = chunkSize(buffer, end);
+                if (size == 0) {
+                    pos = end + 2;
+                    last = true;
+                    break;
+                }
+                if (buffer.size() - (end + 2) < size + 2) return incomplete(eof);
+                if (buffer.compare(end + 2 + size, 2, "\r\n") != 0) {
+                    throw Php::Exception("Wrong chunk data");
+                }
+                body.append(buffer, end + 2, size);
+                pos = end + 2 + size + 2;
+            }
+            while ((end = buffer.find("\r\n", pos)) != pos) {
+                if (end == std::string::npos) return incomplete(eof);
+                pos = end + 2;
+            }
+            return true;
+        }
+        bool parseHttp(const std::string &buffer, bool eof, std::string &response) {
+            if (!head && !readHead(buffer, eof)) return false;
+            if (chunked) {
+                if (!readChunks(buffer, eof)) return false;
+                response.swap(body);
+            }
+            else if (length >= 0) {
+                if (buffer.size() - pos < (size_t)length) return incomplete(eof);
+                response.assign(buffer, pos, (size_t)length);
+            }
+            else {
+                if (!eof) return false;
+                response.assign(buffer, pos, std::string::npos);
+                keep = false;
+            }
+            return true;
+        }
+        bool parseTcp(const std::string &buffer, bool eof, std::string &response) {
+            if (buffer.size() < 4) return incomplete(eof);
+            const unsigned char *p = (const unsigned char *)buffer.data();
+            uint32_t length = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+            if (length > INT32_MAX) throw Php::Exception("Wrong response length");
+            if (buffer.size() - 4 < length) return incomplete(eof);
+            response.assign(buffer, 4, length);
+            keep = true;
+            return true;
+        }
+    public:
+        ResponseParser(bool http = true)
+        : http(http), head(false), chunked(false), last(false), length(-1), keep(true), pos(0) {}
+        /* buffer holds every byte received for this response so far */
+        bool parse(const std::string &buffer, bool eof, std::string &response, bool &keep) {
+            if (!(http ? parseHttp(buffer, eof, response) : parseTcp(buffer, eof, response))) return false;
+            keep = this->keep;
+            return true;
+        }
+    };
+
+    /*
+     * One request and its response over a connection. A connection
+     * taken from the pool may have been closed by the server meanwhile;
+     * exchange returns false when that is found before any byte of the
+     * response arrived, so the request can be sent again.
+     */
+    class Exchange {
+    private:
+        const Endpoint &endpoint;
+        Connection &connection;
+        const Clock::time_point &deadline;
+    public:
+        Exchange(const Endpoint &endpoint, Connection &connection, const Clock::time_point &deadline)
+        : endpoint(endpoint), connection(connection), deadline(deadline) {}
+        bool run(const std::string &body, std::string &response, bool &keep) {
+            std::string request = frame_request(endpoint, body);
+            if (!connection.send(request.data(), request.size(), deadline)) {
+                if (connection.is_reused()) return false;
+                throw Php::Exception("Connection closed by " + endpoint.key());
+            }
+            std::string buffer;
+            if (connection.receive(buffer, deadline) == 0) {
+                if (connection.is_reused()) return false;
+                throw Php::Exception("Connection closed by " + endpoint.key());
+            }
+            bool eof = false;
+            ResponseParser parser(endpoint.http);
+            while (!parser.parse(buffer, eof, response, keep)) {
+                eof = (connection.receive(buffer, deadline) == 0);
+            }
+            return true;
+        }
+    };
+
+    /* sends body to endpoint, reusing a pooled connection when it can */
+    inline std::string send_request(const Endpoint &endpoint, const std::string &body,
+                                    const Clock::time_point &deadline, bool keepalive) {
+        ConnectionPool &pool = connection_pool();
+        for (;;) {
+            Connection connection = keepalive ?
+                                    pool.acquire(endpoint, deadline) :
+                                    Connection::open(endpoint, deadline);
+            std::string response;
+            bool keep = false;
+            try {
+                Exchange exchange(endpoint, connection, deadline);
+                if (!exchange.run(body, response, keep)) {
+                    connection.close();
+                    continue;
+                }
+            }
+            catch (...) {
+                connection.close();
+                throw;
+            }
+            if (keep && keepalive) {
+                pool.release(endpoint, connection);
+            }
+            else {
+                connection.close();
+            }
+            return response;
+        }
+    }
+}
+
+#endif /* HPROSE_CONNECTION_H_ */
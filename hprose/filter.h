@@ -25,7 +25,125 @@
 
 namespace Hprose {
 
-    inline void publish_filter(Php::Extension &ext) {
+    /*
+     * Base of the filters implemented in C++. They change the message
+     * in place, so a chain of them never copies it into a PHP string.
+     * To PHP they look like any HproseFilter.
+     */
+    class NativeFilter : public Php::Base {
+    public:
+        NativeFilter() {}
+        virtual ~NativeFilter() {}
+        virtual void input(std::string &data) = 0;
+        virtual void output(std::string &data) = 0;
+        // -----------------------------------------------------------
+        // for PHP
+        Php::Value inputFilter(Php::Parameters &params) {
+            std::string data = params[0].stringValue();
+            input(data);
+            return data;
+        }
+        Php::Value outputFilter(Php::Parameters &params) {
+            std::string data = params[0].stringValue();
+            output(data);
+            return data;
+        }
+    };
+
+    /*
+     * The native filter behind filter, or nullptr for a filter written
+     * in PHP. Only objects of the native classes (or classes extending
+     * them) have a C++ implementation to cast.
+     */
+    inline NativeFilter *native_filter(const Php::Value &filter) {
+        static const char *classes[] = {
+            "HproseXXTEAFilter", "HproseLZ4Filter", "HproseZstdFilter"
+        };
+        if (!filter.isObject()) return nullptr;
+        for (const char *name : classes) {
+            if (filter.instanceOf(name)) {
+                return dynamic_cast<NativeFilter *>(filter.implementation());
+            }
+        }
+        return nullptr;
+    }
+
+    /*
+     * The filters of a client or a server. Native filters run on the
+     * message in place; it only becomes a PHP string for the filters
+     * written in PHP.
+     */
+    class FilterChain {
+    private:
+        std::vector<Php::Value> filters;
+    public:
+        inline bool empty() const {
+            return filters.empty();
+        }
+        void input(std::string &data, const Php::Value &context) const {
+            for (int32_t i = (int32_t)filters.size() - 1; i >= 0; --i) {
+                NativeFilter *native = native_filter(filters[i]);
+                if (native) {
+                    native->input(data);
+                }
+                else {
+                    data = filters[i].call("inputFilter", data, context).stringValue();
+                }
+            }
+        }
+        void output(std::string &data, const Php::Value &context) const {
+            for (int32_t i = 0, n = (int32_t)filters.size(); i < n; ++i) {
+                NativeFilter *native = native_filter(filters[i]);
+                if (native) {
+                    native->output(data);
+                }
+                else {
+                    data = filters[i].call("outputFilter", data, context).stringValue();
+                }
+            }
+        }
+        Php::Value get() const {
+            if (filters.empty()) return nullptr;
+            return filters[0];
+        }
+        void set(const Php::Value &filter) {
+            filters.clear();
+            if (!filter.isNull()) filters.push_back(filter);
+        }
+        void add(const Php::Value &filter) {
+            filters.push_back(filter);
+        }
+        bool remove(const Php::Value &filter) {
+            for (auto iter = filters.begin(); iter != filters.end(); ++iter) {
+                if (iter->id() == filter.id()) {
+                    filters.erase(iter);
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    /* registers a native filter class as an HproseFilter */
+    template <typename T>
+    inline Php::Class<T> &native_filter_methods(Php::Class<T> &c, const Php::Interface &filter) {
+        c.implements(filter)
+         .method("inputFilter",
+                 &T::inputFilter,
+                 {
+                     Php::ByVal("data", Php::Type::String),
+                     Php::ByVal("context", Php::Type::Null, false)
+                 })
+         .method("outputFilter",
+                 &T::outputFilter,
+                 {
+                     Php::ByVal("data", Php::Type::String),
+                     Php::ByVal("context", Php::Type::Null, false)
+                 });
+        return c;
+    }
+
+    inline Php::Interface publish_filter(Php::Extension &ext) {
         Php::Interface i("HproseFilter");
         i.method("inputFilter",
                  {
@@ -37,7 +155,8 @@ namespace Hprose {
                     Php::ByVal("data", Php::Type::String),
                     Php::ByVal("context", Php::Type::Null)
                 });
-        ext.add(std::move(i));
+        ext.add(i);
+        return i;
     }
 }
 #endif /* HPROSE_FILTER_H_ */
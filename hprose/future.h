@@ -0,0 +1,385 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * hprose/future.h                                        *
+ *                                                        *
+ * hprose asynchronous calls for php-cpp.                 *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#ifndef HPROSE_FUTURE_H_
+#define HPROSE_FUTURE_H_
+
+#include <phpcpp.h>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+
+namespace Hprose {
+
+    /*
+     * One request sent on its own non-blocking connection. It never
+     * waits by itself: progress is called whenever poll finds its socket
+     * ready, and it moves from connecting to sending to receiving until
+     * the response is complete or the call has failed.
+     */
+    class AsyncCall {
+    private:
+        enum State { Connecting, Sending, Receiving, Done };
+        Endpoint endpoint;
+        std::string request;
+        size_t sent;
+        std::string buffer;
+        ResponseParser parser;
+        Connection connection;
+        bool keepalive;
+        State state;
+        void connect() {
+            connection = keepalive ? connection_pool().take(endpoint) : Connection();
+            if (connection.handle() >= 0) {
+                state = Sending;
+                return;
+            }
+            bool pending;
+            connection = Connection::start(endpoint, pending);
+            state = pending ? Connecting : Sending;
+        }
+        /* a pooled connection closed by the server is replaced once */
+        void reconnect() {
+            bool reused = connection.is_reused();
+            connection.close();
+            if (!reused) throw Php::Exception("Connection closed by " + endpoint.key());
+            sent = 0;
+            connect();
+        }
+        void write() {
+#ifdef MSG_NOSIGNAL
+            const int flags = MSG_NOSIGNAL;
+#else
+            const int flags = 0;
+#endif
+            while (sent < request.size()) {
+                ssize_t n = ::send(connection.handle(), request.data() + sent, request.size() - sent, flags);
+                if (n > 0) {
+                    sent += n;
+                }
+                else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return;
+                }
+                else if (errno == EPIPE || errno == ECONNRESET) {
+                    reconnect();
+                    return;
+                }
+                else if (errno != EINTR) {
+                    throw Php::Exception(strerror(errno));
+                }
+            }
+            state = Receiving;
+        }
+        void read() {
+            char chunk[16384];
+            bool eof = false;
+            for (;;) {
+                ssize_t n = ::recv(connection.handle(), chunk, sizeof(chunk), 0);
+                if (n > 0) {
+                    buffer.append(chunk, n);
+                }
+                else if (n == 0 || errno == ECONNRESET) {
+                    eof = true;
+                    break;
+                }
+                else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                else if (errno != EINTR) {
+                    throw Php::Exception(strerror(errno));
+                }
+            }
+            if (eof && buffer.empty()) {
+                reconnect();
+                return;
+            }
+            bool keep = false;
+            if (!parser.parse(buffer, eof, response, keep)) return;
+            if (keep && keepalive && !eof) {
+                connection_pool().release(endpoint, connection);
+            }
+            else {
+                connection.close();
+            }
+            connection = Connection();
+            std::string().swap(buffer);
+            std::string().swap(request);
+            state = Done;
+        }
+    public:
+        Clock::time_point deadline;
+        std::string response;
+        std::string error;
+        AsyncCall(const Endpoint &endpoint, const std::string &body,
+                  const Clock::time_point &deadline, bool keepalive)
+        : endpoint(endpoint), request(frame_request(endpoint, body)), sent(0),
+          parser(endpoint.http), keepalive(keepalive), state(Connecting), deadline(deadline) {
+            try {
+                connect();
+            }
+            catch (Php::Exception &e) {
+                fail(e.message());
+            }
+        }
+        ~AsyncCall() {
+            connection.close();
+        }
+        inline bool done() const {
+            return state == Done;
+        }
+        inline int handle() const {
+            return connection.handle();
+        }
+        inline short events() const {
+            return state == Receiving ? POLLIN : POLLOUT;
+        }
+        void fail(const std::string &message) {
+            connection.close();
+            error = message;
+            state = Done;
+        }
+        void progress() {
+            try {
+                switch (state) {
+                    case Connecting: {
+                        int error = connection.error();
+                        if (error != 0) {
+                            throw Php::Exception("Can't connect to " + endpoint.key() + ": " + strerror(error));
+                        }
+                        state = Sending;
+                        write();
+                        break;
+                    }
+                    case Sending:
+                        write();
+                        break;
+                    case Receiving:
+                        read();
+                        break;
+                    case Done:
+                        break;
+                }
+            }
+            catch (Php::Exception &e) {
+                fail(e.message());
+            }
+        }
+    };
+
+    /*
+     * The calls started by this thread that are not done yet. Waiting
+     * on any future polls all of them, so while a script waits for one
+     * answer, every other call it has started goes on too. A call
+     * added with a key can be joined by later identical calls while it
+     * is running, so they share one request.
+     */
+    class Scheduler {
+    private:
+        std::vector<std::weak_ptr<AsyncCall>> calls;
+        std::unordered_map<std::string, std::weak_ptr<AsyncCall>> running;
+    public:
+        void add(const std::shared_ptr<AsyncCall> &call, const std::string &key = std::string()) {
+            if (call->done()) return;
+            calls.push_back(call);
+            if (!key.empty()) running[key] = call;
+        }
+        /* the running call added with key, if any */
+        std::shared_ptr<AsyncCall> find(const std::string &key) {
+            auto iter = running.find(key);
+            if (iter == running.end()) return nullptr;
+            std::shared_ptr<AsyncCall> call = iter->second.lock();
+            if (call && !call->done()) return call;
+            running.erase(iter);
+            return nullptr;
+        }
+        /*
+         * One poll over the pending calls, waiting no later than until
+         * and the earliest deadline. Calls past their deadline fail with
+         * a timeout. Returns false when nothing is pending.
+         */
+        bool step(const Clock::time_point &until) {
+            std::vector<std::shared_ptr<AsyncCall>> pending;
+            std::vector<struct pollfd> fds;
+            Clock::time_point now = Clock::now(), wake = until;
+            size_t live = 0;
+            for (size_t i = 0; i < calls.size(); ++i) {
+                std::shared_ptr<AsyncCall> call = calls[i].lock();
+                if (!call || call->done()) continue;
+                if (call->deadline <= now) {
+                    call->fail("Request timeout");
+                    continue;
+                }
+                calls[live++] = calls[i];
+                if (call->deadline < wake) wake = call->deadline;
+                pending.push_back(call);
+                fds.push_back(pollfd{ call->handle(), call->events(), 0 });
+            }
+            calls.resize(live);
+            if (pending.empty()) {
+                running.clear();
+                return false;
+            }
+            int n = ::poll(fds.data(), fds.size(), Connection::remaining(wake));
+            if (n < 0 && errno != EINTR) throw Php::Exception(strerror(errno));
+            now = Clock::now();
+            for (size_t i = 0; i < pending.size(); ++i) {
+                if (n > 0 && fds[i].revents) pending[i]->progress();
+                if (!pending[i]->done() && pending[i]->deadline <= now) {
+                    pending[i]->fail("Request timeout");
+                }
+            }
+            return true;
+        }
+        template <typename Predicate>
+        void run(Predicate finished) {
+            while (!finished() && step(Clock::time_point::max())) {}
+        }
+    };
+
+    inline Scheduler &scheduler() {
+#ifdef ZTS
+        static thread_local Scheduler scheduler;
+#else
+        static Scheduler scheduler;
+#endif
+        return scheduler;
+    }
+
+    /*
+     * The PHP side of an asynchronous call. The response is decoded
+     * the first time it is asked for, by the client that started the
+     * call, and kept together with the error, if any.
+     */
+    class Future : public Php::Base {
+    public:
+        typedef std::function<Php::Value(const std::string &)> Decoder;
+    private:
+        std::shared_ptr<AsyncCall> call;
+        Decoder decoder;
+        bool settled;
+        Php::Value result;
+        std::string error;
+        static Future *unwrap(const Php::Value &value) {
+            if (!value.instanceOf("HproseNativeFuture")) throw Php::Exception("HproseNativeFuture expected");
+            return static_cast<Future *>(value.implementation());
+        }
+        inline bool done() const {
+            return settled || !call || call->done();
+        }
+        void settle() {
+            if (settled) return;
+            settled = true;
+            if (!call) {
+                error = "The future is not bound to a call";
+                return;
+            }
+            if (call->error.empty()) {
+                try {
+                    result = decoder(call->response);
+                }
+                catch (Php::Exception &e) {
+                    error = e.message();
+                }
+            }
+            else {
+                error = call->error;
+            }
+            call.reset();
+            decoder = nullptr;
+        }
+        Php::Value get() {
+            scheduler().run([this]() { return done(); });
+            settle();
+            if (!error.empty()) throw Php::Exception(error);
+            return result;
+        }
+    public:
+        Future() : settled(false) {}
+        Future(const std::shared_ptr<AsyncCall> &call, const Decoder &decoder)
+        : call(call), decoder(decoder), settled(false) {}
+        Future(const Php::Value &result) : settled(true), result(result) {}
+        virtual ~Future() {}
+        // -----------------------------------------------------------
+        // for PHP
+        Php::Value isDone() {
+            if (!done()) scheduler().step(Clock::now());
+            return done();
+        }
+        Php::Value wait() {
+            return get();
+        }
+        /* the results in the order and with the keys of the futures */
+        static Php::Value all(Php::Parameters &params) {
+            std::vector<std::pair<Php::Value, Future *>> futures;
+            for (const auto &iter : params[0]) {
+                futures.emplace_back(iter.first, unwrap(iter.second));
+            }
+            scheduler().run([&futures]() {
+                for (auto &future : futures) {
+                    if (!future.second->done()) return false;
+                }
+                return true;
+            });
+            Php::Value results(Php::Type::Array);
+            for (auto &future : futures) {
+                results.set(future.first, future.second->get());
+            }
+            return results;
+        }
+        /* the first successful result; fails only when all the calls fail */
+        static Php::Value any(Php::Parameters &params) {
+            std::vector<Future *> futures;
+            for (const auto &iter : params[0]) {
+                futures.push_back(unwrap(iter.second));
+            }
+            if (futures.empty()) throw Php::Exception("No futures to wait for");
+            std::string error;
+            for (;;) {
+                size_t failed = 0;
+                for (Future *future : futures) {
+                    if (!future->done()) continue;
+                    future->settle();
+                    if (future->error.empty()) return future->result;
+                    error = future->error;
+                    ++failed;
+                }
+                if (failed == futures.size()) throw Php::Exception(error);
+                scheduler().step(Clock::time_point::max());
+            }
+        }
+    };
+
+    inline void publish_future(Php::Extension &ext) {
+        Php::Class<Future> c("HproseNativeFuture");
+        c.method("isDone", &Hprose::Future::isDone)
+         .method("wait", &Hprose::Future::wait)
+         .method("all",
+                 &Hprose::Future::all,
+                 Php::Static | Php::Public,
+                 { Php::ByVal("futures", Php::Type::Array) })
+         .method("any",
+                 &Hprose::Future::any,
+                 Php::Static | Php::Public,
+                 { Php::ByVal("futures", Php::Type::Array) });
+        ext.add(std::move(c));
+    }
+}
+
+#endif /* HPROSE_FUTURE_H_ */
@@ -13,7 +13,7 @@
  *                                                        *
  * hprose for php-cpp.                                    *
  *                                                        *
- * LastModified: Jul 9, 2014                              *
+ * LastModified: Oct 19, 2026                             *
  * Author: Ma Bingyao <andot@hprose.com>                  *
  *                                                        *
 \**********************************************************/
@@ -32,14 +32,21 @@ extern "C" {
         Hprose::publish_stringstream(extension);
         Hprose::publish_classmanager(extension);
         Hprose::publish_resultmode(extension);
-        Hprose::publish_filter(extension);
+        Php::Interface filter = Hprose::publish_filter(extension);
+        Hprose::publish_compressfilter(extension, filter);
+        Hprose::publish_xxteafilter(extension, filter);
         Hprose::publish_common(extension);
         Hprose::publish_writer(extension);
         Hprose::publish_rawreader(extension);
         Hprose::publish_reader(extension);
         Hprose::publish_serialize(extension);
         Hprose::publish_unserialize(extension);
+        Hprose::publish_validator(extension);
+        Hprose::publish_json(extension);
         Hprose::publish_formatter(extension);
+        Hprose::publish_httpserver(extension);
+        Hprose::publish_future(extension);
+        Hprose::publish_client(extension);
 
         // extension.add("hprose\\serialize", hprose_serialize, {
         //     Php::ByRef("val", Php::Type::Null)
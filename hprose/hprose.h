@@ -13,7 +13,7 @@
  *                                                        *
  * hprose header file for php-cpp.                        *
  *                                                        *
- * LastModified: Jul 9, 2014                              *
+ * LastModified: Oct 19, 2026                             *
  * Author: Ma Bingyao <andot@hprose.com>                  *
  *                                                        *
 \**********************************************************/
@@ -30,13 +30,21 @@
 #include "classmanager.h"
 #include "resultmode.h"
 #include "filter.h"
+#include "compressfilter.h"
+#include "xxteafilter.h"
 #include "common.h"
-#include "writer.h"
+#include "validator.h"
 #include "rawreader.h"
+#include "writer.h"
 #include "reader.h"
 #include "serialize.h"
 #include "unserialize.h"
+#include "json.h"
 #include "formatter.h"
 #include "httpserver.h"
+#include "connection.h"
+#include "future.h"
+#include "cache.h"
+#include "client.h"
 
 #endif /* HPROSE_H_ */
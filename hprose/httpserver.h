@@ -13,7 +13,7 @@
  *                                                        *
  * hprose http server class for php-cpp.                  *
  *                                                        *
- * LastModified: Jul 11, 2014                             *
+ * LastModified: Oct 19, 2026                             *
  * Author: Ma Bingyao <andot@hprose.com>                  *
  *                                                        *
 \**********************************************************/
@@ -21,61 +21,13 @@
 #ifndef HPROSE_HTTPSERVER_H_
 #define HPROSE_HTTPSERVER_H_
 
-/*
-
 #include <unordered_map>
-#include <regex>
+#include <algorithm>
+#include <strings.h>
 #include <phpcpp.h>
 
 namespace Hprose {
 
-    const int32_t E_ERROR             = 1;
-    const int32_t E_WARNING           = 2;
-    const int32_t E_PARSE             = 4;
-    const int32_t E_NOTICE            = 8;
-    const int32_t E_CORE_ERROR        = 16;
-    const int32_t E_CORE_WARNING      = 32;
-    const int32_t E_COMPILE_ERROR     = 64;
-    const int32_t E_COMPILE_WARNING   = 128;
-    const int32_t E_USER_ERROR        = 256;
-    const int32_t E_USER_WARNING      = 512;
-    const int32_t E_USER_NOTICE       = 1024;
-    const int32_t E_STRICT            = 2048;
-    const int32_t E_RECOVERABLE_ERROR = 4096;
-    const int32_t E_DEPRECATED        = 8192;
-    const int32_t E_USER_DEPRECATED   = 16384;
-
-#if PHP_VERSION_ID >= 50400
-    const int32_t E_ALL               = 32767;
-#elif PHP_VERSION_ID >= 50300
-    const int32_t E_ALL               = 30719;
-#elif PHP_VERSION_ID >= 50200
-    const int32_t E_ALL               = 6143;
-#else
-    const int32_t E_ALL               = 2047;
-#endif
-
-    inline std::string error_message(int32_t error_code) {
-        switch (error_code) {
-            case E_ERROR: return "Error";
-            case E_WARNING: return "Warning";
-            case E_PARSE: return "Parse Error";
-            case E_NOTICE: return "Notice";
-            case E_CORE_ERROR: return "Core Error";
-            case E_CORE_WARNING: return "Core Warning";
-            case E_COMPILE_ERROR: return "Compile Error";
-            case E_COMPILE_WARNING: return "Compile Warning";
-            case E_USER_ERROR: return "User Error";
-            case E_USER_WARNING: return "User Warning";
-            case E_USER_NOTICE: return "User Notice";
-            case E_STRICT: return "Run-time Notice";
-            case E_RECOVERABLE_ERROR: return "Recoverable Error";
-            case E_DEPRECATED: return "Deprecated";
-            case E_USER_DEPRECATED: return "User Deprecated";
-            default: return "Unknown Error";
-        }
-    }
-
     const char *magic_methods[] = {
         "__construct",
         "__destruct",
@@ -93,64 +45,558 @@ namespace Hprose {
         "__clone"
     };
 
+    inline bool is_magic_method(const std::string &name) {
+        for (const char *magic : magic_methods) {
+            if (strcasecmp(name.c_str(), magic) == 0) return true;
+        }
+        return false;
+    }
+
+    inline std::string lowercase(std::string s) {
+        std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+        return s;
+    }
+
+    struct RemoteFunction {
+        std::string name;
+        Php::Value function;
+        int32_t mode;
+        /* -1 follows the server's simple mode */
+        int32_t simple;
+    };
+
+    /*
+     * The published functions frozen into an open addressing table that
+     * is at most half full. Names are hashed and compared ignoring case
+     * as they come, so a lookup neither lowercases nor allocates.
+     */
+    class MethodTable {
+    private:
+        struct Slot {
+            uint32_t hash;
+            const RemoteFunction *function;
+        };
+        std::vector<Slot> slots;
+        uint32_t mask;
+        static inline uint32_t hash(const char *name, size_t length) {
+            uint32_t h = 2166136261u;
+            for (size_t i = 0; i < length; ++i) {
+                h ^= (uint32_t)::tolower((unsigned char)name[i]);
+                h *= 16777619u;
+            }
+            return h;
+        }
+    public:
+        MethodTable() : mask(0) {}
+        void build(const std::unordered_map<std::string, RemoteFunction> &functions) {
+            size_t size = 4;
+            while (size < functions.size() * 2) size <<= 1;
+            slots.assign(size, Slot{ 0, nullptr });
+            mask = (uint32_t)size - 1;
+            for (const auto &iter : functions) {
+                uint32_t h = hash(iter.first.data(), iter.first.size());
+                uint32_t i = h & mask;
+                while (slots[i].function) i = (i + 1) & mask;
+                slots[i] = Slot{ h, &iter.second };
+            }
+        }
+        const RemoteFunction *find(const char *name, size_t length) const {
+            if (slots.empty()) return nullptr;
+            uint32_t h = hash(name, length);
+            for (uint32_t i = h & mask; slots[i].function; i = (i + 1) & mask) {
+                const Slot &slot = slots[i];
+                if (slot.hash == h &&
+                    slot.function->name.size() == length &&
+                    strncasecmp(slot.function->name.data(), name, length) == 0) {
+                    return slot.function;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    struct RemoteCall {
+        std::string name;
+        const RemoteFunction *remote;
+        Php::Value args;
+        bool byref;
+    };
 
     class HttpServer : public Php::Base {
     private:
-        std::unordered_map<std::string, Php::Value> functions;
-        std::unordered_map<std::string, std::string> funcnames;
-        std::unordered_map<std::string, int32_t> resultmodes;
-        std::unordered_map<std::string, Php::Value> simplemodes;
-        std::vector<Php::Value> filters;
-        std::set<std::string> origins;
-        bool debug = false;
-        bool crossdomain = false;
-        bool p3p = false;
-        bool get = true;
-        bool simple = false;
-        int32_t error_type = E_ALL & ~E_NOTICE;
-        std::string error = "";
-        Php::Value &inputFilter(Php::Value &data) {
-            int32_t count = (int32_t)filters.size();
-            for (int32_t i = count - 1; i >= 0; --i) {
-                data = filters[i].call("inputFilter", data, this);
-            }
-            return data;
-        }
-        Php::Value &outputFilter(Php::Value &data) {
-            int32_t count = (int32_t)filters.size();
-            for (int32_t i = 0; i < count; ++i) {
-                data = filters[i].call("outputFilter", data, this);
-            }
-            return data;
+        std::unordered_map<std::string, RemoteFunction> functions;
+        /* rebuilt on the first lookup after functions changed */
+        MethodTable table;
+        bool dirty;
+        std::vector<std::string> names;
+        FilterChain filters;
+        bool crossdomain;
+        bool p3p;
+        bool get;
+        bool simple;
+        /*
+         * Arguments passed by reference have to be references inside the
+         * array given to call_user_func_array, which can't be built from
+         * here, so that call goes through a small PHP helper.
+         */
+        static Php::Value invoke_byref(const Php::Value &function, Php::Value &args) {
+            if (!Php::call("function_exists", "__hprose_invoke_byref")) {
+                Php::eval("function __hprose_invoke_byref($function, $args) {"
+                          "    $refs = array();"
+                          "    foreach ($args as $i => &$arg) $refs[$i] = &$arg;"
+                          "    $result = call_user_func_array($function, $refs);"
+                          "    return array($result, $args);"
+                          "}");
+            }
+            Php::Value pair = Php::call("__hprose_invoke_byref", function, args);
+            args = pair.get(1);
+            return pair.get(0);
+        }
+        inline void freeze() {
+            if (dirty) {
+                table.build(functions);
+                dirty = false;
+            }
+        }
+        const RemoteFunction &lookup(const std::string &name) {
+            freeze();
+            const RemoteFunction *function = table.find(name.data(), name.size());
+            if (!function) {
+                function = table.find("*", 1);
+                if (!function) {
+                    throw Php::Exception("Can't find this function " + name + "().");
+                }
+            }
+            return *function;
+        }
+        /* the raw result modes send what the method returns as it is */
+        static const Php::Value &raw_result(const Php::Value &result) {
+            if (!result.isString()) {
+                throw Php::Exception("The result of a Raw, Serialized or RawWithEndTag method must be a string");
+            }
+            return result;
+        }
+        void writeResult(StringStream &output, Writer &writer, const RemoteFunction &remote,
+                         const Php::Value &result, const Php::Value &args, bool byref) {
+            switch (remote.mode) {
+                case Raw:
+                    raw_result(result);
+                    output.write(result.rawValue(), result.size());
+                    break;
+                case Serialized:
+                    raw_result(result);
+                    output.write(TagResult).write(result.rawValue(), result.size());
+                    break;
+                default:
+                    output.write(TagResult);
+                    writer.reset();
+                    writer.serialize(result);
+                    if (byref) {
+                        output.write(TagArgument);
+                        writer.reset();
+                        writer.writeList(args);
+                    }
+                    break;
+            }
+        }
+        /*
+         * All calls of a request are decoded before the first one runs,
+         * so a malformed body is rejected without side effects. Every
+         * call starts fresh reference and class tables, as the client
+         * resets its writer between calls, but the reader, the writers
+         * and the response buffer are shared by the whole batch.
+         */
+        void readCalls(StringStream &input, std::vector<RemoteCall> &calls) {
+            Reader reader(input);
+            char tag;
+            do {
+                reader.reset();
+                RemoteCall call;
+                call.name = reader._readString().stringValue();
+                reader.reset();
+                call.remote = &lookup(call.name);
+                call.args = Php::Value(Php::Type::Array);
+                call.byref = false;
+                tag = input.getchar();
+                if (tag == TagList) {
+                    call.args = reader.readListWithoutTag();
+                    tag = input.getchar();
+                    if (tag == TagTrue) {
+                        call.byref = true;
+                        tag = input.getchar();
+                    }
+                }
+                if (tag != TagEnd && tag != TagCall) {
+                    RawReader::unexpectedTag(tag, std::string() + TagEnd + TagCall);
+                }
+                calls.push_back(std::move(call));
+            } while (tag == TagCall);
+        }
+        Php::Value invoke(RemoteCall &call) {
+            const RemoteFunction &remote = *call.remote;
+            if (remote.name == "*") {
+                Php::Value missing(Php::Type::Array);
+                missing.set(0, call.name);
+                missing.set(1, call.args);
+                return Php::call("call_user_func_array", remote.function, missing);
+            }
+            if (call.byref) {
+                return invoke_byref(remote.function, call.args);
+            }
+            return Php::call("call_user_func_array", remote.function, call.args);
+        }
+        /*
+         * Writes the results into output. Returns true instead when the
+         * first call is a RawWithEndTag one, whose result in raw is then
+         * the complete response.
+         */
+        bool doInvoke(StringStream &input, StringStream &output, Php::Value &raw) {
+            std::vector<RemoteCall> calls;
+            readCalls(input, calls);
+            Writer writer(output);
+            Writer simplewriter(output, true);
+            for (RemoteCall &call : calls) {
+                const RemoteFunction &remote = *call.remote;
+                Php::Value result = invoke(call);
+                if (remote.mode == RawWithEndTag) {
+                    raw_result(result);
+                    if (output.size() == 0) {
+                        raw = result;
+                        return true;
+                    }
+                    output.write(result.rawValue(), result.size());
+                    return false;
+                }
+                bool simple = (remote.simple < 0 ? this->simple : remote.simple);
+                writeResult(output, simple ? simplewriter : writer, remote, result, call.args, call.byref);
+            }
+            output.write(TagEnd);
+            return false;
+        }
+        void doFunctionList(StringStream &output) {
+            Writer writer(output, true);
+            output.write(TagFunctions);
+            writer.writeList(names);
+            output.write(TagEnd);
+        }
+        void add(const std::string &alias, const Php::Value &function, int32_t mode, int32_t simple) {
+            if (!Php::is_callable(function)) {
+                throw Php::Exception("Argument function is not a callable variable");
+            }
+            std::string key = lowercase(alias);
+            if (functions.find(key) == functions.end()) {
+                names.push_back(alias);
+            }
+            functions[key] = RemoteFunction{ alias, function, mode, simple };
+            dirty = true;
+        }
+        static int32_t simple_param(Php::Parameters &params, size_t index) {
+            if (params.size() <= index || params[index].isNull()) return -1;
+            return params[index].boolValue() ? 1 : 0;
+        }
+        static int32_t mode_param(Php::Parameters &params, size_t index) {
+            return params.size() > index ? (int32_t)params[index] : Normal;
+        }
+        static std::string alias_param(Php::Parameters &params, size_t index) {
+            return (params.size() > index && !params[index].isNull()) ?
+                   params[index].stringValue() : "";
+        }
+        void addMethods(const Php::Value &scope, const std::string &cls, const std::string &prefix,
+                        bool statics, int32_t mode, int32_t simple) {
+            Php::Value methods = Php::call("get_class_methods", cls);
+            for (const auto &iter : methods) {
+                std::string name = iter.second.stringValue();
+                if (is_magic_method(name)) continue;
+                Php::Object method("ReflectionMethod", cls, name);
+                if (method.call("isStatic").boolValue() != statics) continue;
+                Php::Value function(Php::Type::Array);
+                function.set(0, scope);
+                function.set(1, name);
+                add(prefix.empty() ? name : prefix + "_" + name, function, mode, simple);
+            }
         }
     public:
-        Php::Value __filterHandler(Php::Parameters &params) {
-            Php::Value &data = params[0];
-            std::regex regex("<b>.*? error<\\/b>:(.*?)<br");
-            std::smatch match;
-            if (std::regex_match(data.stringValue(), match, regex)) {
-                std::string error = std::regex_replace(match[1].str(),
-                                                       std::regex(debug ?
-                                                                  "<.*?>" :
-                                                                  " in <b>.*<\\/b>$"),
-                                                       "");
-                data = TagError + serialize_string(trim(error)) + TagEnd;
-            }
-            return outputFilter(data);
-        }
-        Php::Value __errorHandler(Php::Parameters &params) {
-            int32_t err_no = params[0];
-            std::string err_str = params[1];
-            std::string err_file = params[2];
-            std::string err_line = params[3];
-            if (debug) err_str += " in " + err_file + " on line " + err_line;
-            error = error_message(err_no) + ": " + err_str;
-            sendError();
-            Php::exit();
+        HttpServer() : dirty(true), crossdomain(false), p3p(false), get(true), simple(false) {}
+        virtual ~HttpServer() {}
+        Php::Value handle(const Php::Value &data) {
+            StringStream output;
+            try {
+                if (!data.isString()) throw Php::Exception("Wrong Request: string expected");
+                std::string request(data.rawValue(), data.size());
+                filters.input(request, Php::Value(this));
+                StringStream input(std::move(request));
+                char tag = input.getchar();
+                switch (tag) {
+                    case TagCall: {
+                        /* the reader trusts its input, so the body is checked first */
+                        Validator validator;
+                        if (!validator.validate_request(input.str().data(), input.size())) {
+                            throw Php::Exception("Wrong Request: \r\n" + input.str());
+                        }
+                        Php::Value raw;
+                        if (doInvoke(input, output, raw)) {
+                            /* a complete response on its own: hand it out as is */
+                            if (filters.empty()) return raw;
+                            output.write(raw.rawValue(), raw.size());
+                        }
+                        break;
+                    }
+                    case TagEnd: doFunctionList(output); break;
+                    default: throw Php::Exception("Wrong Request: \r\n" + input.str());
+                }
+            }
+            catch (Php::Exception &e) {
+                output.close();
+                output.write(TagError).write(serialize_string(e.message())).write(TagEnd);
+            }
+            catch (std::exception &e) {
+                output.close();
+                output.write(TagError).write(serialize_string(e.what())).write(TagEnd);
+            }
+            filters.output(output.str(), Php::Value(this));
+            return Php::Value(output.str().data(), output.size());
+        }
+        // -----------------------------------------------------------
+        // for PHP
+        void addFunction(Php::Parameters &params) {
+            Php::Value &function = params[0];
+            std::string alias = alias_param(params, 1);
+            if (alias.empty()) {
+                if (function.isString()) {
+                    alias = function.stringValue();
+                }
+                else if (function.isArray()) {
+                    alias = function.get(1).stringValue();
+                }
+                else {
+                    throw Php::Exception("Need an alias");
+                }
+            }
+            add(alias, function, mode_param(params, 2), simple_param(params, 3));
+        }
+        void addFunctions(Php::Parameters &params) {
+            Php::Value &functions = params[0];
+            bool aliased = (params.size() > 1 && params[1].isArray());
+            int32_t mode = mode_param(params, 2);
+            int32_t simple = simple_param(params, 3);
+            for (const auto &iter : functions) {
+                std::string alias;
+                if (aliased) {
+                    alias = params[1].get(iter.first).stringValue();
+                }
+                else if (iter.second.isString()) {
+                    alias = iter.second.stringValue();
+                }
+                else if (iter.second.isArray()) {
+                    alias = iter.second.get(1).stringValue();
+                }
+                else {
+                    throw Php::Exception("Need aliases");
+                }
+                add(alias, iter.second, mode, simple);
+            }
+        }
+        void addMethod(Php::Parameters &params) {
+            Php::Value function(Php::Type::Array);
+            function.set(0, params[1]);
+            function.set(1, params[0]);
+            std::string alias = alias_param(params, 2);
+            if (alias.empty()) alias = params[0].stringValue();
+            add(alias, function, mode_param(params, 3), simple_param(params, 4));
+        }
+        void addMethods(Php::Parameters &params) {
+            Php::Value &methods = params[0];
+            bool aliased = (params.size() > 2 && params[2].isArray());
+            int32_t mode = mode_param(params, 3);
+            int32_t simple = simple_param(params, 4);
+            for (const auto &iter : methods) {
+                Php::Value function(Php::Type::Array);
+                function.set(0, params[1]);
+                function.set(1, iter.second);
+                std::string alias = aliased ?
+                                    params[2].get(iter.first).stringValue() :
+                                    iter.second.stringValue();
+                add(alias, function, mode, simple);
+            }
+        }
+        void addInstanceMethods(Php::Parameters &params) {
+            std::string cls = alias_param(params, 1);
+            if (cls.empty()) cls = Php::call("get_class", params[0]).stringValue();
+            addMethods(params[0], cls, alias_param(params, 2), false,
+                       mode_param(params, 3), simple_param(params, 4));
+        }
+        void addClassMethods(Php::Parameters &params) {
+            std::string cls = params[0].stringValue();
+            Php::Value scope = params.size() > 1 && !params[1].isNull() ? params[1] : params[0];
+            addMethods(scope, cls, alias_param(params, 2), true,
+                       mode_param(params, 3), simple_param(params, 4));
+        }
+        Php::Value isCrossDomainEnabled() const {
+            return crossdomain;
+        }
+        void setCrossDomainEnabled(Php::Parameters &params) {
+            crossdomain = params.size() > 0 ? params[0].boolValue() : true;
+        }
+        Php::Value isP3PEnabled() const {
+            return p3p;
+        }
+        void setP3PEnabled(Php::Parameters &params) {
+            p3p = params.size() > 0 ? params[0].boolValue() : true;
+        }
+        Php::Value isGetEnabled() const {
+            return get;
+        }
+        void setGetEnabled(Php::Parameters &params) {
+            get = params.size() > 0 ? params[0].boolValue() : true;
+        }
+        Php::Value getSimpleMode() const {
+            return simple;
+        }
+        void setSimpleMode(Php::Parameters &params) {
+            simple = params.size() > 0 ? params[0].boolValue() : true;
+        }
+        Php::Value getFilter() const {
+            return filters.get();
+        }
+        void setFilter(Php::Parameters &params) {
+            filters.set(params[0]);
+        }
+        void addFilter(Php::Parameters &params) {
+            filters.add(params[0]);
+        }
+        Php::Value removeFilter(Php::Parameters &params) {
+            return filters.remove(params[0]);
+        }
+        Php::Value handle(Php::Parameters &params) {
+            return handle(params[0]);
+        }
+        void start() {
+            freeze();
+            std::string method = Php::SERVER["REQUEST_METHOD"].stringValue();
+            Php::call("header", "Content-Type: text/plain");
+            if (p3p) {
+                Php::call("header", "P3P: CP=\"CAO DSP COR CUR ADM DEV TAI PSA PSD IVAi IVDi "
+                                    "CONi TELo OTPi OUR DELi SAMi OTRi UNRi PUBi IND PHY ONL "
+                                    "UNI PUR FIN COM NAV INT DEM CNT STA POL HEA PRE GOV\"");
+            }
+            if (crossdomain) {
+                std::string origin = Php::SERVER["HTTP_ORIGIN"].stringValue();
+                if (!origin.empty() && origin != "null") {
+                    Php::call("header", "Access-Control-Allow-Origin: " + origin);
+                    Php::call("header", "Access-Control-Allow-Credentials: true");
+                }
+                else {
+                    Php::call("header", "Access-Control-Allow-Origin: *");
+                }
+            }
+            Php::Value response;
+            if (method == "GET") {
+                if (!get) {
+                    Php::call("header", "HTTP/1.1 403 Forbidden");
+                    return;
+                }
+                StringStream output;
+                doFunctionList(output);
+                filters.output(output.str(), Php::Value(this));
+                response = Php::Value(output.str().data(), output.size());
+            }
+            else if (method == "POST") {
+                response = handle(Php::call("file_get_contents", "php://input"));
+            }
+            else {
+                return;
+            }
+            Php::out.write(response.rawValue(), response.size());
+            Php::out.flush();
         }
     };
-}
 
-*/
+    inline void publish_httpserver(Php::Extension &ext) {
+        Php::Class<HttpServer> c("HproseNativeHttpServer");
+        c.method("addFunction",
+                 &Hprose::HttpServer::addFunction,
+                 {
+                     Php::ByVal("function", Php::Type::Null),
+                     Php::ByVal("alias", Php::Type::String, false),
+                     Php::ByVal("resultMode", Php::Type::Numeric, false),
+                     Php::ByVal("simple", Php::Type::Null, false)
+                 })
+         .method("addFunctions",
+                 &Hprose::HttpServer::addFunctions,
+                 {
+                     Php::ByVal("functions", Php::Type::Array),
+                     Php::ByVal("aliases", Php::Type::Null, false),
+                     Php::ByVal("resultMode", Php::Type::Numeric, false),
+                     Php::ByVal("simple", Php::Type::Null, false)
+                 })
+         .method("addMethod",
+                 &Hprose::HttpServer::addMethod,
+                 {
+                     Php::ByVal("method", Php::Type::String),
+                     Php::ByVal("scope", Php::Type::Null),
+                     Php::ByVal("alias", Php::Type::String, false),
+                     Php::ByVal("resultMode", Php::Type::Numeric, false),
+                     Php::ByVal("simple", Php::Type::Null, false)
+                 })
+         .method("addMethods",
+                 &Hprose::HttpServer::addMethods,
+                 {
+                     Php::ByVal("methods", Php::Type::Array),
+                     Php::ByVal("scope", Php::Type::Null),
+                     Php::ByVal("aliases", Php::Type::Null, false),
+                     Php::ByVal("resultMode", Php::Type::Numeric, false),
+                     Php::ByVal("simple", Php::Type::Null, false)
+                 })
+         .method("addInstanceMethods",
+                 &Hprose::HttpServer::addInstanceMethods,
+                 {
+                     Php::ByVal("object", Php::Type::Object),
+                     Php::ByVal("class", Php::Type::String, false),
+                     Php::ByVal("aliasPrefix", Php::Type::String, false),
+                     Php::ByVal("resultMode", Php::Type::Numeric, false),
+                     Php::ByVal("simple", Php::Type::Null, false)
+                 })
+         .method("addClassMethods",
+                 &Hprose::HttpServer::addClassMethods,
+                 {
+                     Php::ByVal("class", Php::Type::String),
+                     Php::ByVal("scope", Php::Type::Null, false),
+                     Php::ByVal("aliasPrefix", Php::Type::String, false),
+                     Php::ByVal("resultMode", Php::Type::Numeric, false),
+                     Php::ByVal("simple", Php::Type::Null, false)
+                 })
+         .method("isCrossDomainEnabled", &Hprose::HttpServer::isCrossDomainEnabled)
+         .method("setCrossDomainEnabled",
+                 &Hprose::HttpServer::setCrossDomainEnabled,
+                 { Php::ByVal("enable", Php::Type::Bool, false) })
+         .method("isP3PEnabled", &Hprose::HttpServer::isP3PEnabled)
+         .method("setP3PEnabled",
+                 &Hprose::HttpServer::setP3PEnabled,
+                 { Php::ByVal("enable", Php::Type::Bool, false) })
+         .method("isGetEnabled", &Hprose::HttpServer::isGetEnabled)
+         .method("setGetEnabled",
+                 &Hprose::HttpServer::setGetEnabled,
+                 { Php::ByVal("enable", Php::Type::Bool, false) })
+         .method("getSimpleMode", &Hprose::HttpServer::getSimpleMode)
+         .method("setSimpleMode",
+                 &Hprose::HttpServer::setSimpleMode,
+                 { Php::ByVal("simple", Php::Type::Bool, false) })
+         .method("getFilter", &Hprose::HttpServer::getFilter)
+         .method("setFilter",
+                 &Hprose::HttpServer::setFilter,
+                 { Php::ByVal("filter", Php::Type::Null) })
+         .method("addFilter",
+                 &Hprose::HttpServer::addFilter,
+                 { Php::ByVal("filter", Php::Type::Object) })
+         .method("removeFilter",
+                 &Hprose::HttpServer::removeFilter,
+                 { Php::ByVal("filter", Php::Type::Object) })
+         .method("handle",
+                 &Hprose::HttpServer::handle,
+                 { Php::ByVal("data", Php::Type::String) })
+         .method("start", &Hprose::HttpServer::start);
+        ext.add(std::move(c));
+    }
+}
 
 #endif /* HPROSE_HTTPSERVER_H_ */
@@ -0,0 +1,803 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * hprose/json.h                                          *
+ *                                                        *
+ * hprose json transcoder library for php-cpp.            *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#ifndef HPROSE_JSON_H_
+#define HPROSE_JSON_H_
+
+#include <algorithm>
+#include <unordered_map>
+#include <phpcpp.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+namespace Hprose {
+    /* the same values as the json_encode options */
+    const int32_t JSONUnescapedSlashes = 64;
+    const int32_t JSONUnescapedUnicode = 256;
+
+    /*
+     * Transcodes serialized data to JSON by walking the tags like
+     * RawReader does. Refs are resolved by copying the JSON text that
+     * was already produced for the referenced value.
+     */
+    class JSONEncoder : public RawReader {
+    private:
+        struct Ref {
+            const std::string *buffer;
+            size_t start;
+            size_t end;
+        };
+        std::vector<Ref> refs;
+        std::vector<std::vector<std::pair<size_t, size_t>>> classref;
+        std::string names;
+        int32_t flags;
+        size_t limit;
+        inline size_t beginRef(const std::string &out) {
+            refs.push_back({ &out, out.size(), std::string::npos });
+            return refs.size() - 1;
+        }
+        inline void endRef(const size_t index, const std::string &out) {
+            refs[index].end = out.size();
+        }
+        void writeRef(std::string &out) {
+            const Ref &ref = refs[stream->readint(TagSemicolon)];
+            if (ref.end == std::string::npos) {
+                /* a container referring to itself has no JSON form */
+                out.append("null");
+            }
+            else {
+                /* every ref copies its target, so nested refs can grow exponentially */
+                size_t length = ref.end - ref.start;
+                if (length > limit || out.size() > limit - length) {
+                    throw Php::Exception("JSON output exceeds " + std::to_string(limit) + " bytes");
+                }
+                out.append(*ref.buffer, ref.start, length);
+            }
+        }
+        const char *readUTF8(int32_t &n) {
+            int32_t len = stream->readint(TagQuote);
+            const unsigned char *s = (const unsigned char *)stream->peek();
+            n = 0;
+            for (int32_t i = 0; i < len; ++i) {
+                unsigned char c = s[n];
+                if (c < 0x80) {
+                    n += 1;
+                }
+                else if ((c & 0xE0) == 0xC0) {
+                    n += 2;
+                }
+                else if ((c & 0xF0) == 0xE0) {
+                    n += 3;
+                }
+                else {
+                    n += 4;
+                    ++i;
+                }
+            }
+            stream->skip(n + 1);
+            return (const char *)s;
+        }
+        void writeEscaped(std::string &out, const char *str, const int32_t length) {
+            static const char hex[] = "0123456789abcdef";
+            const unsigned char *s = (const unsigned char *)str;
+            out.push_back('"');
+            int32_t start = 0;
+            for (int32_t i = 0; i < length; ++i) {
+                unsigned char c = s[i];
+                const char *escape = nullptr;
+                switch (c) {
+                    case '"': escape = "\\\""; break;
+                    case '\\': escape = "\\\\"; break;
+                    case '/':
+                        if (!(flags & JSONUnescapedSlashes)) escape = "\\/";
+                        break;
+                    case '\b': escape = "\\b"; break;
+                    case '\f': escape = "\\f"; break;
+                    case '\n': escape = "\\n"; break;
+                    case '\r': escape = "\\r"; break;
+                    case '\t': escape = "\\t"; break;
+                    default: break;
+                }
+                if (escape) {
+                    out.append(str + start, i - start).append(escape);
+                    start = i + 1;
+                }
+                else if (c < 0x20 || (c >= 0x80 && !(flags & JSONUnescapedUnicode))) {
+                    out.append(str + start, i - start);
+                    uint32_t unicode = c;
+                    if ((c & 0xE0) == 0xC0) {
+                        unicode = ((c & 0x1F) << 6) | (s[i + 1] & 0x3F);
+                        i += 1;
+                    }
+                    else if ((c & 0xF0) == 0xE0) {
+                        unicode = ((c & 0x0F) << 12) | ((s[i + 1] & 0x3F) << 6) | (s[i + 2] & 0x3F);
+                        i += 2;
+                    }
+                    else if ((c & 0xF8) == 0xF0) {
+                        unicode = ((c & 0x07) << 18) | ((s[i + 1] & 0x3F) << 12) |
+                                  ((s[i + 2] & 0x3F) << 6) | (s[i + 3] & 0x3F);
+                        i += 3;
+                    }
+                    uint32_t units[2] = { unicode, 0 };
+                    int32_t n = 1;
+                    if (unicode >= 0x10000) {
+                        unicode -= 0x10000;
+                        units[0] = 0xD800 | (unicode >> 10);
+                        units[1] = 0xDC00 | (unicode & 0x3FF);
+                        n = 2;
+                    }
+                    for (int32_t j = 0; j < n; ++j) {
+                        char buf[6] = { '\\', 'u',
+                                        hex[(units[j] >> 12) & 0xF],
+                                        hex[(units[j] >> 8) & 0xF],
+                                        hex[(units[j] >> 4) & 0xF],
+                                        hex[units[j] & 0xF] };
+                        out.append(buf, 6);
+                    }
+                    start = i + 1;
+                }
+            }
+            out.append(str + start, length - start).push_back('"');
+        }
+        void writeBase64(std::string &out, const unsigned char *s, const int32_t length) {
+            static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            out.push_back('"');
+            int32_t i = 0;
+            for (; i + 2 < length; i += 3) {
+                uint32_t v = (s[i] << 16) | (s[i + 1] << 8) | s[i + 2];
+                char buf[4] = { table[v >> 18], table[(v >> 12) & 0x3F],
+                                table[(v >> 6) & 0x3F], table[v & 0x3F] };
+                out.append(buf, 4);
+            }
+            if (i < length) {
+                uint32_t v = s[i] << 16;
+                if (i + 1 < length) v |= s[i + 1] << 8;
+                char buf[4] = { table[v >> 18], table[(v >> 12) & 0x3F],
+                                (i + 1 < length) ? table[(v >> 6) & 0x3F] : '=', '=' };
+                out.append(buf, 4);
+            }
+            out.push_back('"');
+        }
+        /*
+         * hprose numbers may have a plus sign, leading zeros, or a point
+         * with no digit on one side, none of which JSON allows.
+         */
+        void writeNumber(std::string &out) {
+            const char *s = stream->peek();
+            const char *end = s;
+            while (*end != TagSemicolon) ++end;
+            stream->skip((int32_t)(end - s) + 1);
+            if (s < end && (*s == TagPos || *s == TagNeg)) {
+                if (*s == TagNeg) out.push_back('-');
+                ++s;
+            }
+            const char *digits = s;
+            while (s < end && *s >= '0' && *s <= '9') ++s;
+            const char *first = digits;
+            while (first + 1 < s && *first == '0') ++first;
+            if (first < s) {
+                out.append(first, s - first);
+            }
+            else {
+                out.push_back('0');
+            }
+            if (s < end && *s == TagPoint) {
+                const char *fraction = ++s;
+                while (s < end && *s >= '0' && *s <= '9') ++s;
+                if (s > fraction) out.append(1, '.').append(fraction, s - fraction);
+            }
+            out.append(s, end - s);
+        }
+        void writeTime(std::string &out) {
+            const char *s = stream->peek();
+            char buf[8] = { s[0], s[1], ':', s[2], s[3], ':', s[4], s[5] };
+            out.append(buf, 8);
+            stream->skip(6);
+            char tag = stream->getchar();
+            if (tag == TagPoint) {
+                out.push_back('.');
+                s = stream->peek();
+                int32_t n = 3;
+                while (n < 9 && s[n] >= '0' && s[n] <= '9') n += 3;
+                out.append(s, n);
+                stream->skip(n);
+                tag = stream->getchar();
+            }
+            if (tag == TagUTC) out.push_back('Z');
+        }
+        void writeDate(std::string &out) {
+            const char *s = stream->peek();
+            char buf[10] = { s[0], s[1], s[2], s[3], '-', s[4], s[5], '-', s[6], s[7] };
+            out.push_back('"');
+            out.append(buf, 10);
+            stream->skip(8);
+            char tag = stream->getchar();
+            if (tag == TagTime) {
+                out.push_back('T');
+                writeTime(out);
+            }
+            else if (tag == TagUTC) {
+                out.push_back('Z');
+            }
+            out.push_back('"');
+        }
+        void writeUTF8Char(std::string &out) {
+            unsigned char c = stream->peek()[0];
+            int32_t n = ((c & 0xE0) == 0xC0) ? 2 : ((c & 0xF0) == 0xE0) ? 3 : 1;
+            writeEscaped(out, stream->peek(), n);
+            stream->skip(n);
+        }
+        void writeString(std::string &out) {
+            size_t index = beginRef(out);
+            int32_t n;
+            const char *s = readUTF8(n);
+            writeEscaped(out, s, n);
+            endRef(index, out);
+        }
+        void writeKey(std::string &out) {
+            char tag = stream->getchar();
+            switch (tag) {
+                case '0':
+                case '1':
+                case '2':
+                case '3':
+                case '4':
+                case '5':
+                case '6':
+                case '7':
+                case '8':
+                case '9':
+                    out.push_back('"');
+                    out.push_back(tag);
+                    out.push_back('"');
+                    break;
+                case TagInteger:
+                case TagLong:
+                case TagDouble:
+                    out.push_back('"');
+                    writeNumber(out);
+                    out.push_back('"');
+                    break;
+                case TagNull:
+                case TagEmpty:
+                case TagFalse:
+                    out.append(tag == TagFalse ? "\"0\"" : "\"\"");
+                    break;
+                case TagTrue:
+                    out.append("\"1\"");
+                    break;
+                case TagUTF8Char:
+                    writeUTF8Char(out);
+                    break;
+                case TagString:
+                    writeString(out);
+                    break;
+                case TagRef: {
+                    size_t pos = out.size();
+                    writeRef(out);
+                    if (out[pos] != '"') throw Php::Exception("Illegal map key");
+                    break;
+                }
+                default:
+                    throw Php::Exception("Illegal map key");
+            }
+        }
+        void readClass() {
+            int32_t n;
+            readUTF8(n);
+            int32_t count = stream->readint(TagOpenbrace);
+            std::vector<std::pair<size_t, size_t>> fields;
+            fields.reserve(count);
+            for (int32_t i = 0; i < count; ++i) {
+                size_t start = names.size();
+                char tag = stream->getchar();
+                switch (tag) {
+                    case TagUTF8Char: writeUTF8Char(names); break;
+                    case TagString: writeString(names); break;
+                    case TagRef: writeRef(names); break;
+                    default: unexpectedTag(tag); break;
+                }
+                fields.push_back(std::make_pair(start, names.size()));
+            }
+            stream->skip(1);
+            classref.push_back(std::move(fields));
+        }
+        void writeObject(std::string &out) {
+            const std::vector<std::pair<size_t, size_t>> &fields = classref[stream->readint(TagOpenbrace)];
+            size_t index = beginRef(out);
+            out.push_back('{');
+            int32_t count = (int32_t)fields.size();
+            for (int32_t i = 0; i < count; ++i) {
+                if (i > 0) out.push_back(',');
+                out.append(names, fields[i].first, fields[i].second - fields[i].first).push_back(':');
+                encode(out, stream->getchar());
+            }
+            stream->skip(1);
+            out.push_back('}');
+            endRef(index, out);
+        }
+    public:
+        /* limit bounds the output, 64 times the input (at least 1MB) when 0 */
+        JSONEncoder(StringStream &stream, int32_t flags = 0, size_t limit = 0)
+        : RawReader(stream), flags(flags),
+          limit(limit > 0 ? limit : std::max<size_t>((size_t)stream.size() * 64, 1 << 20)) {}
+        virtual ~JSONEncoder() {}
+        void encode(std::string &out, const char tag) {
+            switch (tag) {
+                case '0':
+                case '1':
+                case '2':
+                case '3':
+                case '4':
+                case '5':
+                case '6':
+                case '7':
+                case '8':
+                case '9':
+                    out.push_back(tag);
+                    break;
+                case TagInteger:
+                case TagLong:
+                case TagDouble:
+                    writeNumber(out);
+                    break;
+                case TagNull: out.append("null"); break;
+                case TagEmpty: out.append("\"\""); break;
+                case TagTrue: out.append("true"); break;
+                case TagFalse: out.append("false"); break;
+                case TagInfinity:
+                    stream->skip(1);
+                    // no break here
+                case TagNaN:
+                    /* json_encode gives 0 for partial output of NAN and INF */
+                    out.push_back('0');
+                    break;
+                case TagDate:
+                case TagTime: {
+                    size_t index = beginRef(out);
+                    if (tag == TagDate) {
+                        writeDate(out);
+                    }
+                    else {
+                        out.push_back('"');
+                        writeTime(out);
+                        out.push_back('"');
+                    }
+                    endRef(index, out);
+                    break;
+                }
+                case TagBytes: {
+                    size_t index = beginRef(out);
+                    int32_t count = stream->readint(TagQuote);
+                    writeBase64(out, (const unsigned char *)stream->peek(), count);
+                    stream->skip(count + 1);
+                    endRef(index, out);
+                    break;
+                }
+                case TagUTF8Char:
+                    writeUTF8Char(out);
+                    break;
+                case TagString:
+                    writeString(out);
+                    break;
+                case TagGuid: {
+                    size_t index = beginRef(out);
+                    writeEscaped(out, stream->peek() + 1, 36);
+                    stream->skip(38);
+                    endRef(index, out);
+                    break;
+                }
+                case TagList: {
+                    size_t index = beginRef(out);
+                    int32_t count = stream->readint(TagOpenbrace);
+                    out.push_back('[');
+                    for (int32_t i = 0; i < count; ++i) {
+                        if (i > 0) out.push_back(',');
+                        encode(out, stream->getchar());
+                    }
+                    stream->skip(1);
+                    out.push_back(']');
+                    endRef(index, out);
+                    break;
+                }
+                case TagMap: {
+                    size_t index = beginRef(out);
+                    int32_t count = stream->readint(TagOpenbrace);
+                    out.push_back('{');
+                    for (int32_t i = 0; i < count; ++i) {
+                        if (i > 0) out.push_back(',');
+                        writeKey(out);
+                        out.push_back(':');
+                        encode(out, stream->getchar());
+                    }
+                    stream->skip(1);
+                    out.push_back('}');
+                    endRef(index, out);
+                    break;
+                }
+                case TagClass:
+                    readClass();
+                    encode(out, stream->getchar());
+                    break;
+                case TagObject:
+                    writeObject(out);
+                    break;
+                case TagRef:
+                    writeRef(out);
+                    break;
+                case TagError: {
+                    int32_t n = 0;
+                    const char *s = "";
+                    switch (stream->getchar()) {
+                        case TagUTF8Char: {
+                            unsigned char c = stream->peek()[0];
+                            s = stream->peek();
+                            n = ((c & 0xE0) == 0xC0) ? 2 : ((c & 0xF0) == 0xE0) ? 3 : 1;
+                            break;
+                        }
+                        case TagString: s = readUTF8(n); break;
+                        default: break;
+                    }
+                    throw Php::Exception(std::string(s, n));
+                }
+                default:
+                    unexpectedTag(tag);
+                    break;
+            }
+        }
+        std::string encode() {
+            std::string out;
+            out.reserve(stream->size());
+            encode(out, stream->getchar());
+            return out;
+        }
+    };
+
+    /*
+     * Transcodes JSON to serialized data with the same encoding rules
+     * as Writer::serialize uses for the result of json_decode. The
+     * first pass only counts the elements of every array and object,
+     * because the count has to be written before the elements.
+     */
+    class JSONDecoder {
+    private:
+        static const int32_t max_depth = 512;
+        const char *data;
+        const char *p;
+        const char *end;
+        StringStream &stream;
+        bool simple;
+        std::vector<int32_t> counts;
+        size_t next;
+        std::unordered_map<std::string, int32_t> ref;
+        int32_t refcount;
+        std::string buffer;
+        void error() {
+            throw Php::Exception("Syntax error in JSON at offset " + std::to_string(p - data));
+        }
+        inline void whitespace() {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+        }
+        inline void expect(const char *literal, int32_t length) {
+            if (end - p < length || memcmp(p, literal, length) != 0) error();
+            p += length;
+        }
+        inline uint32_t hex4() {
+            if (end - p < 4) error();
+            uint32_t u = 0;
+            for (int32_t i = 0; i < 4; ++i) {
+                char c = *p++;
+                u <<= 4;
+                if (c >= '0' && c <= '9') u |= c - '0';
+                else if (c >= 'a' && c <= 'f') u |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') u |= c - 'A' + 10;
+                else error();
+            }
+            return u;
+        }
+        void readString(std::string &s) {
+            ++p;
+            s.clear();
+            const char *start = p;
+            for (;;) {
+                if (p >= end) error();
+                unsigned char c = *p;
+                if (c == '"') break;
+                if (c < 0x20) error();
+                if (c != '\\') {
+                    ++p;
+                    continue;
+                }
+                s.append(start, p - start);
+                if (++p >= end) error();
+                switch (*p++) {
+                    case '"': s.push_back('"'); break;
+                    case '\\': s.push_back('\\'); break;
+                    case '/': s.push_back('/'); break;
+                    case 'b': s.push_back('\b'); break;
+                    case 'f': s.push_back('\f'); break;
+                    case 'n': s.push_back('\n'); break;
+                    case 'r': s.push_back('\r'); break;
+                    case 't': s.push_back('\t'); break;
+                    case 'u': {
+                        uint32_t u = hex4();
+                        if (u >= 0xDC00 && u <= 0xDFFF) error();
+                        if (u >= 0xD800 && u <= 0xDBFF) {
+                            expect("\\u", 2);
+                            uint32_t low = hex4();
+                            if (low < 0xDC00 || low > 0xDFFF) error();
+                            u = 0x10000 + ((u - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        if (u < 0x80) {
+                            s.push_back((char)u);
+                        }
+                        else if (u < 0x800) {
+                            s.push_back((char)(0xC0 | (u >> 6)));
+                            s.push_back((char)(0x80 | (u & 0x3F)));
+                        }
+                        else if (u < 0x10000) {
+                            s.push_back((char)(0xE0 | (u >> 12)));
+                            s.push_back((char)(0x80 | ((u >> 6) & 0x3F)));
+                            s.push_back((char)(0x80 | (u & 0x3F)));
+                        }
+                        else {
+                            s.push_back((char)(0xF0 | (u >> 18)));
+                            s.push_back((char)(0x80 | ((u >> 12) & 0x3F)));
+                            s.push_back((char)(0x80 | ((u >> 6) & 0x3F)));
+                            s.push_back((char)(0x80 | (u & 0x3F)));
+                        }
+                        break;
+                    }
+                    default: --p; error(); break;
+                }
+                start = p;
+            }
+            s.append(start, p - start);
+            ++p;
+            if (!is_utf8(s)) error();
+        }
+        void skipString() {
+            ++p;
+            while (p < end && *p != '"') {
+                if (*p == '\\') ++p;
+                ++p;
+            }
+            if (p >= end) error();
+            ++p;
+        }
+        bool skipNumber() {
+            bool integer = true;
+            if (p < end && *p == '-') ++p;
+            if (p >= end || *p < '0' || *p > '9') error();
+            if (*p == '0') {
+                ++p;
+            }
+            else {
+                while (p < end && *p >= '0' && *p <= '9') ++p;
+            }
+            if (p < end && *p == '.') {
+                integer = false;
+                if (++p >= end || *p < '0' || *p > '9') error();
+                while (p < end && *p >= '0' && *p <= '9') ++p;
+            }
+            if (p < end && (*p == 'e' || *p == 'E')) {
+                integer = false;
+                if (++p < end && (*p == '+' || *p == '-')) ++p;
+                if (p >= end || *p < '0' || *p > '9') error();
+                while (p < end && *p >= '0' && *p <= '9') ++p;
+            }
+            return integer;
+        }
+        void scan(int32_t depth) {
+            whitespace();
+            if (p >= end) error();
+            char c = *p;
+            if (c != '[' && c != '{') {
+                switch (c) {
+                    case '"': skipString(); break;
+                    case 't': expect("true", 4); break;
+                    case 'f': expect("false", 5); break;
+                    case 'n': expect("null", 4); break;
+                    default: skipNumber(); break;
+                }
+                return;
+            }
+            if (depth >= max_depth) error();
+            char close = (c == '[') ? ']' : '}';
+            size_t index = counts.size();
+            counts.push_back(0);
+            ++p;
+            whitespace();
+            if (p < end && *p == close) {
+                ++p;
+                return;
+            }
+            for (;;) {
+                if (c == '{') {
+                    whitespace();
+                    if (p >= end || *p != '"') error();
+                    skipString();
+                    whitespace();
+                    if (p >= end || *p++ != ':') error();
+                }
+                scan(depth + 1);
+                ++counts[index];
+                whitespace();
+                if (p >= end) error();
+                if (*p == close) {
+                    ++p;
+                    return;
+                }
+                if (*p++ != ',') error();
+            }
+        }
+        void writeString(const std::string &s) {
+            if (s.empty()) {
+                stream.write(TagEmpty);
+                return;
+            }
+            int32_t len = ustrlen(s);
+            if (s.size() < 4 && len == 1) {
+                stream.write(TagUTF8Char).write(s);
+                return;
+            }
+            if (!simple) {
+                auto iter = ref.find(s);
+                if (iter != ref.end()) {
+                    stream.write(TagRef).write(iter->second).write(TagSemicolon);
+                    return;
+                }
+                ref[s] = refcount++;
+            }
+            stream.write(TagString).write(len).write(TagQuote).write(s).write(TagQuote);
+        }
+        void writeNumber() {
+            const char *start = p;
+            bool integer = skipNumber();
+            std::string number(start, p - start);
+            if (integer) {
+                errno = 0;
+                int64_t i = strtoll(number.c_str(), nullptr, 10);
+                if (errno != ERANGE) {
+                    if (i >= 0 && i <= 9) {
+                        stream.write((char)('0' + i));
+                    }
+                    else if (i >= INT32_MIN && i <= INT32_MAX) {
+                        stream.write(TagInteger).write((int32_t)i).write(TagSemicolon);
+                    }
+                    else {
+                        stream.write(TagLong).write(i).write(TagSemicolon);
+                    }
+                    return;
+                }
+            }
+            /* json_decode gives a float for integers out of range too */
+            double d = strtod(number.c_str(), nullptr);
+            if (isinf(d)) {
+                stream.write(TagInfinity).write(d > 0 ? TagPos : TagNeg);
+            }
+            else {
+                stream.write(TagDouble).write(d).write(TagSemicolon);
+            }
+        }
+        void writeContainer(const char close) {
+            int32_t count = counts[next++];
+            if (!simple) ++refcount;
+            stream.write(close == ']' ? TagList : TagMap);
+            if (count > 0) stream.write(count);
+            stream.write(TagOpenbrace);
+            ++p;
+            for (int32_t i = 0; i < count; ++i) {
+                if (i > 0) {
+                    whitespace();
+                    ++p;
+                }
+                if (close == '}') {
+                    whitespace();
+                    readString(buffer);
+                    writeString(buffer);
+                    whitespace();
+                    ++p;
+                }
+                write();
+            }
+            whitespace();
+            ++p;
+            stream.write(TagClosebrace);
+        }
+        void write() {
+            whitespace();
+            switch (*p) {
+                case '[': writeContainer(']'); break;
+                case '{': writeContainer('}'); break;
+                case '"':
+                    readString(buffer);
+                    writeString(buffer);
+                    break;
+                case 't': p += 4; stream.write(TagTrue); break;
+                case 'f': p += 5; stream.write(TagFalse); break;
+                case 'n': p += 4; stream.write(TagNull); break;
+                default: writeNumber(); break;
+            }
+        }
+    public:
+        JSONDecoder(StringStream &stream, bool simple = false)
+        : stream(stream), simple(simple), next(0), refcount(0) {}
+        void decode(const char *json, int32_t length) {
+            data = p = json;
+            end = json + length;
+            counts.clear();
+            scan(0);
+            whitespace();
+            if (p != end) error();
+            p = data;
+            next = 0;
+            ref.clear();
+            refcount = 0;
+            write();
+        }
+    };
+
+    Php::Value to_json(Php::Parameters &params) {
+        Php::Value &data = params[0];
+        if (!data.isString()) throw Php::Exception("hprose_to_json expects a string");
+        int32_t flags = 0;
+        if (params.size() > 1) flags = params[1];
+        int64_t limit = 0;
+        if (params.size() > 2) limit = params[2];
+        Validator validator;
+        if (!validator.validate(data.rawValue(), data.size())) {
+            throw Php::Exception("incorrect serialization data");
+        }
+        StringStream stream(data);
+        JSONEncoder encoder(stream, flags, limit > 0 ? (size_t)limit : 0);
+        return encoder.encode();
+    }
+
+    Php::Value from_json(Php::Parameters &params) {
+        Php::Value &json = params[0];
+        if (!json.isString()) throw Php::Exception("hprose_from_json expects a string");
+        bool simple = false;
+        if (params.size() > 1) simple = params[1];
+        StringStream stream;
+        JSONDecoder decoder(stream, simple);
+        decoder.decode(json.rawValue(), json.size());
+        return stream.to_string();
+    }
+
+    inline void publish_json(Php::Extension &ext) {
+        ext.add("hprose_to_json",
+                &to_json,
+                {
+                    Php::ByVal("s", Php::Type::String),
+                    Php::ByVal("flags", Php::Type::Numeric, false),
+                    Php::ByVal("limit", Php::Type::Numeric, false)
+                })
+        .add("hprose_from_json",
+             &from_json,
+             {
+                 Php::ByVal("json", Php::Type::String),
+                 Php::ByVal("simple", Php::Type::Bool, false)
+             });
+    }
+}
+
+#endif /* HPROSE_JSON_H_ */
@@ -13,7 +13,7 @@
  *                                                        *
  * hprose reader class for php-cpp.                       *
  *                                                        *
- * LastModified: Mar 21, 2015                             *
+ * LastModified: Oct 19, 2026                             *
  * Author: Ma Bingyao <andot@hprose.com>                  *
  *                                                        *
 \**********************************************************/
@@ -21,6 +21,9 @@
 #ifndef HPROSE_READER_H_
 #define HPROSE_READER_H_
 
+#include <deque>
+#include <unordered_map>
+#include <map>
 #include <phpcpp.h>
 #include <math.h>
 
@@ -62,10 +65,74 @@ namespace Hprose {
         virtual ~RealReaderRefer() {}
     };
 
+    /*
+     * Keeps only the values that a later element reads back, as found
+     * by Validator::track, and drops each one after its last reader.
+     */
+    class StreamReaderRefer : public ReaderRefer {
+    private:
+        const std::unordered_map<int32_t, int32_t> &uses;
+        std::unordered_map<int32_t, Php::Value> live;
+        std::multimap<int32_t, int32_t> expiry;
+        int32_t count;
+    public:
+        virtual void set(const Php::Value &value) override {
+            auto iter = uses.find(count);
+            if (iter != uses.end()) {
+                live[count] = value;
+                expiry.emplace(iter->second, count);
+            }
+            ++count;
+        }
+        virtual const Php::Value &read(int32_t index) override {
+            auto iter = live.find(index);
+            if (iter == live.end()) {
+                throw Php::Exception("incorrect serialization data");
+            }
+            return iter->second;
+        }
+        virtual void reset() override {
+            live.clear();
+            expiry.clear();
+            count = 0;
+        }
+        /* releases the values no element from this one on reads */
+        void advance(int32_t element) {
+            while (!expiry.empty() && expiry.begin()->first < element) {
+                live.erase(expiry.begin()->second);
+                expiry.erase(expiry.begin());
+            }
+        }
+        StreamReaderRefer(const std::unordered_map<int32_t, int32_t> &uses)
+        : uses(uses), count(0) {}
+        virtual ~StreamReaderRefer() {}
+    };
+
+    /*
+     * A class definition read from the stream, prepared once so that
+     * every object of the class reuses the resolved class name and the
+     * field names as PHP strings. When hprose.object_constructor is off,
+     * it also keeps the ReflectionClass that creates the objects without
+     * calling their constructor.
+     */
+    struct ClassPlan {
+        std::string classname;
+        std::vector<Php::Value> fields;
+        Php::Value reflection;
+    };
+
     class Reader : public RawReader {
     private:
-        std::vector<std::pair<std::string, std::vector<std::string>>> classref;
+        /* a deque keeps plans in place while nested classes are added */
+        std::deque<ClassPlan> classref;
         ReaderRefer *refer;
+        /*
+         * Opt-in table sharing one PHP string per distinct string, map
+         * keys included. PHP 5 still copies each key into the hash, but
+         * a repeated key no longer makes a new PHP string first.
+         */
+        bool intern;
+        std::unordered_map<std::string, Php::Value> strings;
         inline void init_refer(bool simple) {
             if (simple) {
                 refer = new FakeReaderRefer();
@@ -115,30 +182,73 @@ namespace Hprose {
             stream->skip(1);
             return s;
         }
+        int32_t _readUTF8CharWithoutTag(char *buf) {
+            int32_t i = 1;
+            buf[0] = stream->getchar();
+            if ((buf[0] & 0xE0) == 0xC0) {
+                buf[1] = stream->getchar();
+                ++i;
+            }
+            else if ((buf[0] & 0xF0) == 0xE0) {
+                buf[1] = stream->getchar();
+                buf[2] = stream->getchar();
+                i += 2;
+            }
+            else if (buf[0] > 0x7F) {
+                throw Php::Exception("bad utf-8 encoding");
+            }
+            return i;
+        }
+        Php::Value readInterned(const char tag) {
+            std::string s;
+            if (tag == TagString) {
+                s = _readStringWithoutTag();
+            }
+            else {
+                char buf[4];
+                s.assign(buf, _readUTF8CharWithoutTag(buf));
+            }
+            auto iter = strings.find(s);
+            if (iter == strings.end()) {
+                Php::Value value = s;
+                iter = strings.emplace(std::move(s), value).first;
+            }
+            if (tag == TagString) refer->set(iter->second);
+            return iter->second;
+        }
         Php::Value readRef() {
             return refer->read(stream->readint(TagSemicolon));
         }
         void readClass() {
-            std::string classname = ClassManager::get_class(_readStringWithoutTag());
-            int32_t count = stream->readint(TagOpenbrace);
-            std::vector<std::string> fields;
+            ClassPlan plan;
+            plan.classname = ClassManager::get_class(_readStringWithoutTag());
+            if (!Php::ini_get("hprose.object_constructor").boolValue()) {
+                plan.reflection = Php::Object("ReflectionClass", plan.classname);
+            }
+            int32_t count = readCount(2);
+            plan.fields.reserve(count);
             for (int32_t i = 0; i < count; ++i) {
-                fields.push_back(_readString());
+                plan.fields.push_back(_readString());
             }
             stream->skip(1);
-            classref.push_back(std::move(std::make_pair(classname, fields)));
+            classref.push_back(std::move(plan));
         }
     public:
-        Reader() : RawReader() {};
-        Reader(StringStream &stream, bool simple = false) : RawReader(stream) {
+        Reader() : RawReader(), intern(false) {};
+        Reader(StringStream &stream, bool simple = false, bool intern = false)
+        : RawReader(stream), intern(intern) {
             init_refer(simple);
         }
+        /* takes ownership of refer */
+        Reader(StringStream &stream, ReaderRefer *refer)
+        : RawReader(stream), refer(refer), intern(false) {}
         virtual ~Reader() {
             reset();
             delete refer;
         }
         inline void reset() {
             classref.clear();
+            strings.clear();
             refer->reset();
         }
         Php::Value readIntegerWithoutTag() {
@@ -307,20 +417,7 @@ namespace Hprose {
         }
         Php::Value readUTF8CharWithoutTag() {
             char buf[4];
-            int32_t i = 1;
-            buf[0] = stream->getchar();
-            if ((buf[0] & 0xE0) == 0xC0) {
-                buf[1] = stream->getchar();
-                ++i;
-            }
-            else if ((buf[0] & 0xF0) == 0xE0) {
-                buf[1] = stream->getchar();
-                buf[2] = stream->getchar();
-                i += 2;
-            }
-            else if (buf[0] > 0x7F) {
-                throw Php::Exception("bad utf-8 encoding");
-            }
+            int32_t i = _readUTF8CharWithoutTag(buf);
             return Php::Value(buf, i);
         }
         Php::Value readStringWithoutTag() {
@@ -331,8 +428,11 @@ namespace Hprose {
         Php::Value _readString() {
             char tag = stream->getchar();
             switch (tag) {
-                case TagUTF8Char: return readUTF8CharWithoutTag();
-                case TagString: return readStringWithoutTag();
+                case TagUTF8Char:
+                case TagString:
+                    if (intern) return readInterned(tag);
+                    if (tag == TagString) return readStringWithoutTag();
+                    return readUTF8CharWithoutTag();
                 case TagRef: return readRef();
                 default: unexpectedTag(tag); break;
             }
@@ -343,8 +443,8 @@ namespace Hprose {
             switch (tag) {
                 case TagNull: return nullptr;
                 case TagEmpty: return "";
-                case TagUTF8Char: return readUTF8CharWithoutTag();
-                case TagString: return readStringWithoutTag();
+                case TagUTF8Char: return intern ? readInterned(tag) : readUTF8CharWithoutTag();
+                case TagString: return intern ? readInterned(tag) : readStringWithoutTag();
                 case TagRef: return readRef();
                 default: unexpectedTag(tag); break;
             }
@@ -367,10 +467,21 @@ namespace Hprose {
             }
             return nullptr;
         }
+        /*
+         * Every element takes at least min bytes in the stream, so a count
+         * the remaining data cannot hold is rejected before allocating.
+         */
+        inline int32_t readCount(const int32_t min) {
+            int32_t count = stream->readint(TagOpenbrace);
+            if (count < 0 || count > stream->available() / min) {
+                throw Php::Exception("incorrect serialization data");
+            }
+            return count;
+        }
         Php::Value readListWithoutTag() {
+            int32_t count = readCount(1);
             Php::Value list(Php::Type::Array);
             refer->set(list.ref());
-            int32_t count = stream->readint(TagOpenbrace);
             for (int32_t i = 0; i < count; ++i) {
                 list.set(i, unserialize());
             }
@@ -390,7 +501,7 @@ namespace Hprose {
         Php::Value readMapWithoutTag() {
             Php::Value map(Php::Type::Array);
             refer->set(map.ref());
-            int32_t count = stream->readint(TagOpenbrace);
+            int32_t count = readCount(2);
             for (int32_t i = 0; i < count; ++i) {
                 Php::Value key = unserialize();
                 Php::Value value = unserialize();
@@ -410,14 +521,19 @@ namespace Hprose {
             return nullptr;
         }
         Php::Value readObjectWithoutTag() {
-            auto pair = classref[stream->readint(TagOpenbrace)];
-            std::string classname = pair.first;
-            std::vector<std::string> fields = pair.second;
-            Php::Value object = Php::Object(classname.c_str());
+            int32_t index = stream->readint(TagOpenbrace);
+            if (index < 0 || index >= (int32_t)classref.size()) {
+                throw Php::Exception("incorrect serialization data");
+            }
+            const ClassPlan &plan = classref[index];
+            Php::Value object = plan.reflection.isNull() ?
+                                Php::Object(plan.classname.c_str()) :
+                                plan.reflection.call("newInstanceWithoutConstructor");
             refer->set(object);
-            int32_t count = (int32_t)fields.size();
+            int32_t count = (int32_t)plan.fields.size();
             for (int32_t i = 0; i < count; ++i) {
-                object.set(fields[i], unserialize());
+                const Php::Value &field = plan.fields[i];
+                object.set(field.rawValue(), field.size(), unserialize());
             }
             stream->skip(1);
             return object;
@@ -434,7 +550,9 @@ namespace Hprose {
             return nullptr;
         }
         Php::Value unserialize() {
-            char tag = stream->getchar();
+            return unserialize(stream->getchar());
+        }
+        Php::Value unserialize(const char tag) {
             switch (tag) {
                 case '0': return 0;
                 case '1': return 1;
@@ -458,8 +576,8 @@ namespace Hprose {
                 case TagDate: return readDateWithoutTag();
                 case TagTime: return readTimeWithoutTag();
                 case TagBytes: return readBytesWithoutTag();
-                case TagUTF8Char: return readUTF8CharWithoutTag();
-                case TagString: return readStringWithoutTag();
+                case TagUTF8Char: return intern ? readInterned(tag) : readUTF8CharWithoutTag();
+                case TagString: return intern ? readInterned(tag) : readStringWithoutTag();
                 case TagGuid: return readGuidWithoutTag();
                 case TagList: return readListWithoutTag();
                 case TagMap: return readMapWithoutTag();
@@ -479,6 +597,9 @@ namespace Hprose {
             if (params.size() > 1) {
                 simple = params[1];
             }
+            if (params.size() > 2) {
+                intern = params[2];
+            }
             init_refer(simple);
         }
     };
@@ -489,7 +610,8 @@ namespace Hprose {
                  &Hprose::Reader::__construct,
                  {
                      Php::ByVal("stream", "HproseStringStream"),
-                     Php::ByVal("simple", Php::Type::Bool, false)
+                     Php::ByVal("simple", Php::Type::Bool, false),
+                     Php::ByVal("intern", Php::Type::Bool, false)
                  })
         .method("unserialize",
                 &Hprose::Reader::unserialize, {}, true)
@@ -543,6 +665,7 @@ namespace Hprose {
                 &Hprose::Reader::readObject)
         .method("reset", &Hprose::Reader::reset);
         ext.add(std::move(c));
+        ext.add(Php::Ini("hprose.object_constructor", true));
     }
 }
 
@@ -13,7 +13,7 @@
  *                                                        *
  * hprose serialize library for php-cpp.                  *
  *                                                        *
- * LastModified: Jul 19, 2014                             *
+ * LastModified: Oct 19, 2026                             *
  * Author: Ma Bingyao <andot@hprose.com>                  *
  *                                                        *
 \**********************************************************/
@@ -63,15 +63,18 @@ namespace Hprose {
         }
     }
 
-    inline std::string serialize(Php::Value &value, bool simple = false) {
+    inline std::string serialize(Php::Value &value, bool simple = false, bool traversable = false) {
         StringStream stream;
-        Writer writer(stream, simple);
+        Writer writer(stream, simple, traversable);
         writer.serialize(value);
         return stream.to_string();
     }
 
     inline Php::Value serialize(Php::Parameters &params) {
-        if (params.size() > 1) {
+        if (params.size() > 2) {
+            return serialize(params[0], params[1], params[2]);
+        }
+        else if (params.size() > 1) {
             return serialize(params[0], params[1]);
         }
         else {
@@ -79,6 +82,25 @@ namespace Hprose {
         }
     }
 
+    /*
+     * Each value is encoded on its own, but one stream and one writer
+     * serve the whole batch.
+     */
+    Php::Value serialize_batch(Php::Parameters &params) {
+        bool simple = false;
+        if (params.size() > 1) simple = params[1];
+        StringStream stream;
+        Writer writer(stream, simple);
+        Php::Value result(Php::Type::Array);
+        for (const auto &iter : params[0]) {
+            writer.serialize(iter.second);
+            result.set(iter.first, Php::Value(stream.peek(), stream.available()));
+            writer.reset();
+            stream.close();
+        }
+        return result;
+    }
+
     inline void publish_serialize(Php::Extension &ext) {
         ext.add("hprose_serialize_bool",
                 &serialize_bool,
@@ -100,6 +122,13 @@ namespace Hprose {
              &serialize,
              {
                  Php::ByVal("v", Php::Type::Null),
+                 Php::ByVal("simple", Php::Type::Bool, false),
+                 Php::ByVal("traversable", Php::Type::Bool, false)
+             })
+        .add("hprose_serialize_batch",
+             &serialize_batch,
+             {
+                 Php::ByVal("values", Php::Type::Array),
                  Php::ByVal("simple", Php::Type::Bool, false)
              });
     }
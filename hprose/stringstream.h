@@ -13,7 +13,7 @@
  *                                                        *
  * hprose stringstream class for php-cpp.                 *
  *                                                        *
- * LastModified: Feb 27, 2015                             *
+ * LastModified: Oct 19, 2026                             *
  * Author: Ma Bingyao <andot@hprose.com>                  *
  *                                                        *
 \**********************************************************/
@@ -33,7 +33,7 @@ namespace Hprose {
     public:
         StringStream() : buffer(""), pos(0), _mark(-1) {
         }
-        StringStream(const std::string str) : buffer(str), pos(0), _mark(-1) {
+        StringStream(std::string str) : buffer(std::move(str)), pos(0), _mark(-1) {
         }
         virtual ~StringStream() {}
         void close() {
@@ -41,6 +41,12 @@ namespace Hprose {
             pos = 0;
             _mark = -1;
         }
+        /* replaces the content, keeping the allocated buffer */
+        void assign(const char *str, const int32_t length) {
+            buffer.assign(str, length);
+            pos = 0;
+            _mark = -1;
+        }
         inline int32_t size() const {
             return (int32_t)buffer.length();
         }
@@ -102,6 +108,12 @@ namespace Hprose {
         inline bool eof() const {
             return pos >= size();
         }
+        inline int32_t available() const {
+            return size() - pos;
+        }
+        inline const char *peek() const {
+            return buffer.data() + pos;
+        }
         inline StringStream &write(const std::string str, const int32_t length = -1) {
             if (length == -1) {
                 buffer.append(str);
@@ -133,6 +145,14 @@ namespace Hprose {
             buffer.append(buf, n);
             return *this;
         }
+        inline StringStream &insert(const int32_t at, const std::string &str) {
+            buffer.insert(at, str);
+            return *this;
+        }
+        /* the whole buffer, for filters working in place */
+        inline std::string &str() {
+            return buffer;
+        }
         inline std::string to_string() const {
             return buffer;
         }
@@ -13,7 +13,7 @@
  *                                                        *
  * hprose unserialize library for php-cpp.                *
  *                                                        *
- * LastModified: Feb 27, 2015                             *
+ * LastModified: Oct 19, 2026                             *
  * Author: Ma Bingyao <andot@hprose.com>                  *
  *                                                        *
 \**********************************************************/
@@ -26,9 +26,11 @@
 namespace Hprose {
     Php::Value unserialize_with_stream(Php::Parameters &params) {
         bool simple = false;
+        bool intern = false;
         if (params.size() > 1) simple = params[1];
+        if (params.size() > 2) intern = params[2];
         StringStream *stream = (StringStream *)params[0].implementation();
-        Reader reader(*stream, simple);
+        Reader reader(*stream, simple, intern);
         return reader.unserialize();
     }
 
@@ -46,18 +48,161 @@ namespace Hprose {
 
     inline Php::Value unserialize(Php::Parameters &params) {
         bool simple = false;
+        bool intern = false;
         if (params.size() > 1) simple = params[1];
+        if (params.size() > 2) intern = params[2];
         StringStream stream(params[0]);
-        Reader reader(stream, simple);
+        Reader reader(stream, simple, intern);
         return reader.unserialize();
     }
 
+    Php::Value unserialize_batch(Php::Parameters &params) {
+        bool simple = false;
+        bool intern = false;
+        if (params.size() > 1) simple = params[1];
+        if (params.size() > 2) intern = params[2];
+        StringStream stream;
+        Reader reader(stream, simple, intern);
+        Php::Value result(Php::Type::Array);
+        for (const auto &iter : params[0]) {
+            const Php::Value &data = iter.second;
+            if (!data.isString()) throw Php::Exception("hprose_unserialize_batch expects an array of strings");
+            stream.assign(data.rawValue(), data.size());
+            result.set(iter.first, reader.unserialize());
+            reader.reset();
+        }
+        return result;
+    }
+
+    /*
+     * Decodes the elements of a top-level list, or the values of a
+     * concatenated stream, one at a time. A validating pre-scan tells
+     * which references later elements read, so only those are kept.
+     */
+    class UnserializeIterator : public Php::Base, public Php::Traversable {
+    private:
+        class Cursor : public Php::Iterator {
+        private:
+            UnserializeIterator *owner;
+        public:
+            Cursor(UnserializeIterator *owner) : Php::Iterator(owner), owner(owner) {}
+            virtual ~Cursor() {}
+            virtual bool valid() override {
+                return owner->valid();
+            }
+            virtual Php::Value current() override {
+                return owner->current;
+            }
+            virtual Php::Value key() override {
+                return owner->index;
+            }
+            virtual void next() override {
+                ++owner->index;
+                owner->fetch();
+            }
+            virtual void rewind() override {
+                if (owner->started) {
+                    if (owner->index > 0) {
+                        throw Php::Exception("Cannot rewind a stream that was already read");
+                    }
+                    return;
+                }
+                owner->started = true;
+                owner->fetch();
+            }
+        };
+        Php::Value source;
+        StringStream buffer;
+        StringStream *stream;
+        std::unordered_map<int32_t, int32_t> uses;
+        StreamReaderRefer *refer;
+        Reader *reader;
+        bool list;
+        bool started;
+        bool done;
+        int32_t count;
+        int32_t index;
+        Php::Value current;
+        bool valid() {
+            if (!started) {
+                started = true;
+                fetch();
+            }
+            return !done;
+        }
+        void fetch() {
+            current = nullptr;
+            if (list ? index >= count : stream->available() <= 0) {
+                if (list && !done) stream->skip(1);
+                done = true;
+                return;
+            }
+            refer->advance(index);
+            current = reader->unserialize();
+        }
+        void open(StringStream &s) {
+            stream = &s;
+            Validator validator;
+            validator.track(&uses);
+            list = (stream->available() > 0 && *stream->peek() == TagList &&
+                    validator.validate(stream->peek(), stream->available()));
+            if (!list && !validator.validate_each(stream->peek(), stream->available())) {
+                throw Php::Exception("incorrect serialization data");
+            }
+            refer = new StreamReaderRefer(uses);
+            reader = new Reader(*stream, refer);
+            if (list) {
+                if (uses.count(0)) {
+                    throw Php::Exception("Cannot stream a list that references itself");
+                }
+                stream->skip(1);
+                refer->set(nullptr);
+                count = stream->readint(TagOpenbrace);
+            }
+        }
+    public:
+        UnserializeIterator()
+        : stream(nullptr), refer(nullptr), reader(nullptr), list(false),
+          started(false), done(false), count(0), index(0) {}
+        virtual ~UnserializeIterator() {
+            /* reader owns refer */
+            delete reader;
+        }
+        void open(const Php::Value &value) {
+            if (value.isObject() && value.instanceOf("HproseStringStream")) {
+                source = value;
+                open(*(StringStream *)value.implementation());
+            }
+            else if (value.isString()) {
+                buffer.write(value.rawValue(), value.size());
+                open(buffer);
+            }
+            else {
+                throw Php::Exception("hprose_unserialize_iter expects a string or an HproseStringStream");
+            }
+        }
+        virtual Php::Iterator *getIterator() override {
+            return new Cursor(this);
+        }
+    };
+
+    Php::Value unserialize_iter(Php::Parameters &params) {
+        UnserializeIterator *iterator = new UnserializeIterator();
+        Php::Object result("HproseUnserializeIterator", iterator);
+        iterator->open(params[0]);
+        return result;
+    }
+
     inline void publish_unserialize(Php::Extension &ext) {
+        Php::Class<UnserializeIterator> c("HproseUnserializeIterator");
+        c.method("__construct", Php::Private);
+        ext.add(std::move(c));
         ext.add("hprose_unserialize_with_stream",
                 &unserialize_with_stream,
                 {
                     Php::ByVal("s", "HproseStringStream"),
-                    Php::ByVal("simple", Php::Type::Bool, false)
+                    Php::ByVal("simple", Php::Type::Bool, false),
+                    Php::ByVal("intern", Php::Type::Bool, false)
                 },
                 true)
         .add("hprose_unserialize_list_with_stream",
@@ -72,13 +217,26 @@ namespace Hprose {
                  Php::ByVal("s", "HproseStringStream")
              },
              true)
+        .add("hprose_unserialize_iter",
+             &unserialize_iter,
+             {
+                 Php::ByVal("s", Php::Type::Null)
+             })
         .add("hprose_unserialize",
              &unserialize,
              {
                  Php::ByVal("s", Php::Type::String),
-                 Php::ByVal("simple", Php::Type::Bool, false)
+                 Php::ByVal("simple", Php::Type::Bool, false),
+                 Php::ByVal("intern", Php::Type::Bool, false)
              },
-             true);
+             true)
+        .add("hprose_unserialize_batch",
+             &unserialize_batch,
+             {
+                 Php::ByVal("data", Php::Type::Array),
+                 Php::ByVal("simple", Php::Type::Bool, false),
+                 Php::ByVal("intern", Php::Type::Bool, false)
+             });
     }
 }
 
@@ -0,0 +1,448 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * hprose/validator.h                                     *
+ *                                                        *
+ * hprose validator library for php-cpp.                  *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#ifndef HPROSE_VALIDATOR_H_
+#define HPROSE_VALIDATOR_H_
+
+#include <phpcpp.h>
+#include <unordered_map>
+
+namespace Hprose {
+
+    /*
+     * Checks serialized data in a single pass over the raw bytes,
+     * mirroring what Reader::unserialize would accept, but without
+     * creating any PHP values.
+     */
+    class Validator {
+    private:
+        static const int32_t inline_classes = 64;
+        const char *p;
+        const char *end;
+        int32_t max_depth;
+        int32_t max_count;
+        int32_t max_length;
+        int32_t depth;
+        int32_t count;
+        int32_t refcount;
+        int32_t backrefs;
+        int32_t classcount;
+        int32_t fields[inline_classes];
+        std::vector<int32_t> more_fields;
+        /* optional: last top-level element using each referenced index */
+        std::unordered_map<int32_t, int32_t> *uses;
+        int32_t element;
+        bool each;
+        inline bool readint(const char tag, int32_t &n) {
+            n = 0;
+            while (p < end && *p != tag) {
+                char c = *p++;
+                if (c < '0' || c > '9') return false;
+                if (n > (INT32_MAX - (c - '0')) / 10) return false;
+                n = n * 10 + (c - '0');
+            }
+            if (p >= end) return false;
+            ++p;
+            return true;
+        }
+        inline int32_t skipdigits() {
+            const char *start = p;
+            while (p < end && *p >= '0' && *p <= '9') ++p;
+            return (int32_t)(p - start);
+        }
+        /*
+         * [+-]digits for integers; a real needs a digit before or after
+         * its point, and an exponent needs digits too, as std::stod does.
+         */
+        inline bool number(bool real) {
+            if (p < end && (*p == TagPos || *p == TagNeg)) ++p;
+            int32_t n = skipdigits();
+            if (real) {
+                if (p < end && *p == TagPoint) {
+                    ++p;
+                    n += skipdigits();
+                }
+                if (n == 0) return false;
+                if (p < end && (*p == 'e' || *p == 'E')) {
+                    ++p;
+                    if (p < end && (*p == TagPos || *p == TagNeg)) ++p;
+                    if (skipdigits() == 0) return false;
+                }
+            }
+            else if (n == 0) {
+                return false;
+            }
+            return p < end && *p++ == TagSemicolon;
+        }
+        inline bool digits(int32_t n) {
+            if (end - p < n) return false;
+            for (int32_t i = 0; i < n; ++i, ++p) {
+                if (*p < '0' || *p > '9') return false;
+            }
+            return true;
+        }
+        inline bool timezone() {
+            if (p >= end) return false;
+            char tag = *p++;
+            return tag == TagUTC || tag == TagSemicolon;
+        }
+        bool time() {
+            if (!digits(6)) return false;
+            if (p < end && *p == TagPoint) {
+                ++p;
+                if (!digits(3)) return false;
+                if (p < end && *p >= '0' && *p <= '9') {
+                    if (!digits(3)) return false;
+                    if (p < end && *p >= '0' && *p <= '9') {
+                        if (!digits(3)) return false;
+                    }
+                }
+            }
+            return timezone();
+        }
+        bool date() {
+            if (!digits(8)) return false;
+            if (p < end && *p == TagTime) {
+                ++p;
+                return time();
+            }
+            return timezone();
+        }
+        inline bool continuation(int32_t n) {
+            if (end - p < n) return false;
+            for (int32_t i = 0; i < n; ++i, ++p) {
+                if ((*p & 0xC0) != 0x80) return false;
+            }
+            return true;
+        }
+        bool utf8char() {
+            if (p >= end) return false;
+            unsigned char c = *p++;
+            if (c < 0x80) return true;
+            if ((c & 0xE0) == 0xC0) return c >= 0xC2 && continuation(1);
+            if ((c & 0xF0) == 0xE0) return continuation(2);
+            return false;
+        }
+        bool string() {
+            int32_t len;
+            if (!readint(TagQuote, len) || len > max_length) return false;
+            for (int32_t i = 0; i < len; ++i) {
+                if (p >= end) return false;
+                unsigned char c = *p++;
+                if (c < 0x80) continue;
+                if ((c & 0xE0) == 0xC0) {
+                    if (c < 0xC2 || !continuation(1)) return false;
+                }
+                else if ((c & 0xF0) == 0xE0) {
+                    if (!continuation(2)) return false;
+                }
+                else if ((c & 0xF8) == 0xF0 && c <= 0xF4) {
+                    if (++i >= len || !continuation(3)) return false;
+                }
+                else {
+                    return false;
+                }
+            }
+            return p < end && *p++ == TagQuote;
+        }
+        bool bytes() {
+            int32_t len;
+            if (!readint(TagQuote, len) || len > max_length) return false;
+            if (end - p <= len) return false;
+            p += len;
+            return *p++ == TagQuote;
+        }
+        bool guid() {
+            if (end - p < 38 || p[0] != TagOpenbrace || p[37] != TagClosebrace) return false;
+            p += 38;
+            return true;
+        }
+        inline bool ref() {
+            int32_t index;
+            if (!readint(TagSemicolon, index) || index >= refcount) return false;
+            ++backrefs;
+            if (uses) (*uses)[index] = element;
+            return true;
+        }
+        inline bool open(const char tag, int32_t &n) {
+            if (!readint(tag, n) || n > max_length) return false;
+            /* every element takes at least one byte */
+            return n <= end - p;
+        }
+        inline bool close() {
+            return p < end && *p++ == TagClosebrace;
+        }
+        bool field() {
+            if (p >= end) return false;
+            switch (*p++) {
+                case TagUTF8Char: return utf8char();
+                case TagString: ++refcount; return string();
+                case TagRef: return ref();
+                default: return false;
+            }
+        }
+        bool classdef() {
+            int32_t n;
+            if (!string() || !open(TagOpenbrace, n)) return false;
+            for (int32_t i = 0; i < n; ++i) {
+                if (!field()) return false;
+            }
+            if (!close()) return false;
+            if (classcount < inline_classes) {
+                fields[classcount] = n;
+            }
+            else {
+                more_fields.push_back(n);
+            }
+            ++classcount;
+            return true;
+        }
+        bool object() {
+            int32_t index;
+            if (!readint(TagOpenbrace, index) || index >= classcount) return false;
+            int32_t n = (index < inline_classes ?
+                         fields[index] :
+                         more_fields[index - inline_classes]);
+            ++refcount;
+            for (int32_t i = 0; i < n; ++i) {
+                if (!value()) return false;
+            }
+            return close();
+        }
+        /* class definitions may come one after another, so they loop */
+        bool objectvalue() {
+            for (;;) {
+                if (p >= end) return false;
+                switch (*p++) {
+                    case TagNull: return true;
+                    case TagClass: if (!classdef()) return false; break;
+                    case TagObject: return object();
+                    case TagRef: return ref();
+                    default: return false;
+                }
+            }
+        }
+        bool stringvalue() {
+            if (p >= end) return false;
+            switch (*p++) {
+                case TagNull:
+                case TagEmpty: return true;
+                case TagUTF8Char: return utf8char();
+                case TagString: ++refcount; return string();
+                case TagRef: return ref();
+                default: return false;
+            }
+        }
+        bool list() {
+            int32_t n;
+            ++refcount;
+            if (!open(TagOpenbrace, n)) return false;
+            bool top = (!each && depth == 1);
+            for (int32_t i = 0; i < n; ++i) {
+                if (top) element = i;
+                if (!value()) return false;
+            }
+            return close();
+        }
+        bool map() {
+            int32_t n;
+            ++refcount;
+            if (!open(TagOpenbrace, n)) return false;
+            for (int32_t i = 0; i < n; ++i) {
+                if (!value() || !value()) return false;
+            }
+            return close();
+        }
+        bool value() {
+            if (p >= end || ++count > max_count) return false;
+            char tag = *p++;
+            switch (tag) {
+                case '0':
+                case '1':
+                case '2':
+                case '3':
+                case '4':
+                case '5':
+                case '6':
+                case '7':
+                case '8':
+                case '9':
+                case TagNull:
+                case TagEmpty:
+                case TagTrue:
+                case TagFalse:
+                case TagNaN:
+                    return true;
+                case TagInfinity:
+                    if (p >= end) return false;
+                    tag = *p++;
+                    return tag == TagPos || tag == TagNeg;
+                case TagInteger:
+                case TagLong:
+                    return number(false);
+                case TagDouble:
+                    return number(true);
+                case TagDate:
+                    ++refcount;
+                    return date();
+                case TagTime:
+                    ++refcount;
+                    return time();
+                case TagBytes:
+                    ++refcount;
+                    return bytes();
+                case TagUTF8Char:
+                    return utf8char();
+                case TagString:
+                    ++refcount;
+                    return string();
+                case TagGuid:
+                    ++refcount;
+                    return guid();
+                case TagRef:
+                    return ref();
+                case TagError:
+                    return stringvalue();
+                default:
+                    break;
+            }
+            if (++depth > max_depth) return false;
+            bool result;
+            switch (tag) {
+                case TagList: result = list(); break;
+                case TagMap: result = map(); break;
+                case TagClass: result = classdef() && objectvalue(); break;
+                case TagObject: result = object(); break;
+                default: result = false; break;
+            }
+            --depth;
+            return result;
+        }
+        /* Reader throws on an error where it expects a value */
+        inline bool toplevel() {
+            return p < end && *p != TagError && value();
+        }
+        /* a fresh reference and class table, as after Reader::reset */
+        inline void restart() {
+            refcount = 0;
+            classcount = 0;
+            more_fields.clear();
+        }
+        void start(const char *data, int32_t length, bool each) {
+            this->each = each;
+            p = data;
+            end = data + length;
+            depth = 0;
+            count = 0;
+            backrefs = 0;
+            element = 0;
+            restart();
+            if (uses) uses->clear();
+        }
+    public:
+        Validator(int32_t max_depth = 512,
+                  int32_t max_count = INT32_MAX,
+                  int32_t max_length = INT32_MAX)
+        : max_depth(max_depth), max_count(max_count), max_length(max_length),
+          uses(nullptr) {}
+        /*
+         * Records, for every reference index that the data reads back,
+         * the last element that reads it: the element of a top-level
+         * list for validate, the value itself for validate_each.
+         */
+        inline void track(std::unordered_map<int32_t, int32_t> *uses) {
+            this->uses = uses;
+        }
+        bool validate(const char *data, int32_t length) {
+            start(data, length, false);
+            return toplevel() && p == end;
+        }
+        /* accepts a sequence of values sharing one reference table */
+        bool validate_each(const char *data, int32_t length) {
+            start(data, length, true);
+            while (p < end) {
+                if (!toplevel()) return false;
+                ++element;
+            }
+            return true;
+        }
+        /*
+         * Accepts the body of a call request: one or more calls, each of
+         * a name and an optional argument list with an optional byref
+         * flag, ending with z. The name and the arguments each start a
+         * new reference table, as the server resets its reader for both.
+         */
+        bool validate_request(const char *data, int32_t length) {
+            start(data, length, true);
+            do {
+                if (p >= end || *p++ != TagCall || p >= end) return false;
+                restart();
+                switch (*p++) {
+                    case TagUTF8Char: if (!utf8char()) return false; break;
+                    case TagString: if (!string()) return false; break;
+                    default: return false;
+                }
+                restart();
+                if (p < end && *p == TagList) {
+                    if (!value()) return false;
+                    if (p < end && *p == TagTrue) ++p;
+                }
+            } while (p < end && *p == TagCall);
+            return p + 1 == end && *p == TagEnd;
+        }
+        inline int32_t refs() const {
+            return refcount;
+        }
+        /* how many r tags the data has */
+        inline int32_t refuses() const {
+            return backrefs;
+        }
+        inline int32_t classes() const {
+            return classcount;
+        }
+    };
+
+    Php::Value validate(Php::Parameters &params) {
+        Php::Value &data = params[0];
+        if (!data.isString()) throw Php::Exception("hprose_validate expects a string");
+        int32_t max_depth = 512;
+        int32_t max_count = INT32_MAX;
+        int32_t max_length = INT32_MAX;
+        if (params.size() > 1) {
+            Php::Value &limits = params[1];
+            if (limits.contains("depth")) max_depth = limits.get("depth");
+            if (limits.contains("count")) max_count = limits.get("count");
+            if (limits.contains("length")) max_length = limits.get("length");
+        }
+        Validator validator(max_depth, max_count, max_length);
+        return validator.validate(data.rawValue(), data.size());
+    }
+
+    inline void publish_validator(Php::Extension &ext) {
+        ext.add("hprose_validate",
+                &validate,
+                {
+                    Php::ByVal("s", Php::Type::String),
+                    Php::ByVal("limits", Php::Type::Array, false)
+                });
+    }
+}
+
+#endif /* HPROSE_VALIDATOR_H_ */
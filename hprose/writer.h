@@ -13,7 +13,7 @@
  *                                                        *
  * hprose writer class for php-cpp.                       *
  *                                                        *
- * LastModified: Feb 27, 2015                             *
+ * LastModified: Oct 19, 2026                             *
  * Author: Ma Bingyao <andot@hprose.com>                  *
  *                                                        *
 \**********************************************************/
@@ -24,12 +24,16 @@
 #include <unordered_map>
 #include <phpcpp.h>
 #include <math.h>
+#ifdef ZTS
+#include <mutex>
+#endif
 
 namespace Hprose {
     class WriterRefer {
     public:
         virtual void set(const Php::Value &value) = 0;
         virtual bool write(const Php::Value &value) = 0;
+        virtual int32_t skip(int32_t n) = 0;
         virtual void reset() = 0;
         WriterRefer() {}
         virtual ~WriterRefer() {}
@@ -41,6 +45,9 @@ namespace Hprose {
         virtual bool write(const Php::Value &value) override {
             return false;
         };
+        virtual int32_t skip(int32_t n) override {
+            return -1;
+        }
         virtual void reset() override {};
         FakeWriterRefer() {}
         virtual ~FakeWriterRefer() {}
@@ -85,17 +92,78 @@ namespace Hprose {
             }
             return false;
         };
+        virtual int32_t skip(int32_t n) override {
+            int32_t index = refcount;
+            refcount += n;
+            return index;
+        }
         virtual void reset() override {
             ref.clear();
             refcount = 0;
         };
     };
 
+    /*
+     * Encoded class headers shared by all writers of the process. The
+     * field names in a header are always written as plain strings, so
+     * the bytes don't depend on the writer they are copied into.
+     */
+    class ClassHeaderCache {
+    private:
+        static const size_t max_size = 4096;
+        std::unordered_map<std::string, std::string> headers;
+#ifdef ZTS
+        std::mutex mutex;
+#endif
+        static std::string encode(const std::string &alias, const std::vector<std::string> &fields) {
+            StringStream header;
+            header.write(TagClass).write((int32_t)alias.size()).write(TagQuote).write(alias).write(TagQuote);
+            int32_t count = (int32_t)fields.size();
+            if (count > 0) header.write(count);
+            header.write(TagOpenbrace);
+            for (int32_t i = 0; i < count; ++i) {
+                int32_t len = ustrlen(fields[i]);
+                header.write(TagString);
+                if (len > 0) header.write(len);
+                header.write(TagQuote).write(fields[i]).write(TagQuote);
+            }
+            header.write(TagClosebrace);
+            return header.to_string();
+        }
+    public:
+        void write(StringStream &stream, const std::string &alias, const std::vector<std::string> &fields) {
+            std::string key = alias;
+            for (auto &field : fields) {
+                key.push_back('\0');
+                key.append(field);
+            }
+#ifdef ZTS
+            std::lock_guard<std::mutex> lock(mutex);
+#endif
+            auto iter = headers.find(key);
+            if (iter == headers.end()) {
+                std::string header = encode(alias, fields);
+                if (headers.size() >= max_size) {
+                    stream.write(header.data(), (int32_t)header.size());
+                    return;
+                }
+                iter = headers.emplace(std::move(key), std::move(header)).first;
+            }
+            stream.write(iter->second.data(), (int32_t)iter->second.size());
+        }
+    };
+
+    inline ClassHeaderCache &class_header_cache() {
+        static ClassHeaderCache cache;
+        return cache;
+    }
+
     class Writer : public Php::Base {
     private:
-        std::map<std::string, int32_t> classref;
+        std::unordered_map<std::string, int32_t> classref;
         std::vector<std::vector<std::string>> fieldsref;
         WriterRefer *refer;
+        bool traversable;
         inline void init_refer(bool simple) {
             if (simple) {
                 refer = new FakeWriterRefer();
@@ -104,10 +172,61 @@ namespace Hprose {
                 refer = new RealWriterRefer(stream);
             }
         }
+        void writeRaw(StringStream &fragment, const char tag, int32_t refbase, int32_t classbase) {
+            switch (tag) {
+                case TagRef:
+                    stream->write(TagRef)
+                           .write(refbase + fragment.readint(TagSemicolon))
+                           .write(TagSemicolon);
+                    break;
+                case TagList:
+                case TagMap: {
+                    stream->write(tag).write(fragment.readuntil(TagOpenbrace)).write(TagOpenbrace);
+                    char t;
+                    while ((t = fragment.getchar()) != TagClosebrace) {
+                        writeRaw(fragment, t, refbase, classbase);
+                    }
+                    stream->write(TagClosebrace);
+                    break;
+                }
+                case TagClass: {
+                    std::string len = fragment.readuntil(TagQuote);
+                    stream->write(TagClass).write(len).write(TagQuote)
+                           .write(fragment.readuntil(TagQuote)).write(TagQuote)
+                           .write(fragment.readuntil(TagOpenbrace)).write(TagOpenbrace);
+                    char t;
+                    while ((t = fragment.getchar()) != TagClosebrace) {
+                        writeRaw(fragment, t, refbase, classbase);
+                    }
+                    stream->write(TagClosebrace);
+                    /* the class keeps its index but is not reused by alias */
+                    fieldsref.push_back(std::vector<std::string>());
+                    writeRaw(fragment, fragment.getchar(), refbase, classbase);
+                    break;
+                }
+                case TagObject: {
+                    stream->write(TagObject)
+                           .write(classbase + fragment.readint(TagOpenbrace))
+                           .write(TagOpenbrace);
+                    char t;
+                    while ((t = fragment.getchar()) != TagClosebrace) {
+                        writeRaw(fragment, t, refbase, classbase);
+                    }
+                    stream->write(TagClosebrace);
+                    break;
+                }
+                default: {
+                    RawReader reader(fragment);
+                    reader.readRaw(*stream, tag);
+                    break;
+                }
+            }
+        }
     public:
         StringStream *stream;
-        Writer() {};
-        Writer(StringStream &stream, bool simple = false) : stream(&stream) {
+        Writer() : traversable(false) {};
+        Writer(StringStream &stream, bool simple = false, bool traversable = false)
+        : traversable(traversable), stream(&stream) {
             init_refer(simple);
         }
         virtual ~Writer() {
@@ -251,54 +370,83 @@ namespace Hprose {
             stream->write(TagMap);
             if (count > 0) stream->write(count);
             stream->write(TagOpenbrace);
-            for (auto &iter : val) {
+            for (const auto &iter : val) {
                 serialize(iter.first);
                 serialize(iter.second);
-            };
+            }
             stream->write(TagClosebrace);
         }
         void writeMapWithRef(const Php::Value &value) {
             if (!refer->write(value)) writeMap(value);
         }
         int32_t writeClass(const std::string alias, std::vector<std::string> &fields) {
-            stream->write(TagClass).write((int32_t)alias.size()).write(TagQuote).write(alias).write(TagQuote);
-            int32_t count = (int32_t)fields.size();
-            if (count > 0) stream->write(count);
-            stream->write(TagOpenbrace);
-            for (int32_t i = 0; i < count; ++i) {
-                writeString(fields[i]);
-            }
-            stream->write(TagClosebrace);
+            class_header_cache().write(*stream, alias, fields);
+            /* the field names take ref indexes, but are never referenced */
+            refer->skip((int32_t)fields.size());
             int32_t index = (int32_t)fieldsref.size();
             fieldsref.push_back(fields);
-            classref[alias] = index;
             return index;
         }
         void writeObject(const Php::Value &value) {
             std::string classname = value.className();
-            std::string alias = ClassManager::get_alias(classname);
-            std::vector<std::string> fields;
             int32_t index;
-            auto find = classref.find(alias);
+            auto find = classref.find(classname);
             if (find == classref.end()) {
-                fields = value.properties(false);
-                index = writeClass(alias, fields);
+                std::vector<std::string> props = value.properties(false);
+                index = writeClass(ClassManager::get_alias(classname), props);
+                classref[classname] = index;
             }
             else {
-                index = classref[alias];
-                fields = fieldsref[index];
+                index = find->second;
             }
             refer->set(value);
-            int32_t count = (int32_t)fields.size();
+            int32_t count = (int32_t)fieldsref[index].size();
             stream->write(TagObject).write(index).write(TagOpenbrace);
             for (int32_t i = 0; i < count; ++i) {
-                serialize(value.get(fields[i]));
+                /* fieldsref may grow while the field value is written */
+                serialize(value.get(fieldsref[index][i]));
             }
             stream->write(TagClosebrace);
         }
         void writeObjectWithRef(const Php::Value &value) {
             if (!refer->write(value)) writeObject(value);
         }
+        /*
+         * Writes the values (or the key-value pairs when map is true) of
+         * an iterator as they come. The count is only known at the end,
+         * so the header is inserted in front of the elements then.
+         */
+        void writeTraversable(const Php::Value &value, bool map = false) {
+            refer->set(value);
+            int32_t start = stream->size();
+            int32_t count = 0;
+            for (const auto &iter : value) {
+                if (map) serialize(iter.first);
+                serialize(iter.second);
+                ++count;
+            }
+            std::string header(1, map ? TagMap : TagList);
+            if (count > 0) header.append(std::to_string(count));
+            header.append(1, TagOpenbrace);
+            stream->insert(start, header).write(TagClosebrace);
+        }
+        void writeTraversableWithRef(const Php::Value &value, bool map = false) {
+            if (!refer->write(value)) writeTraversable(value, map);
+        }
+        void writeRaw(const char *data, const int32_t length) {
+            Validator validator;
+            if (!validator.validate(data, length)) {
+                throw Php::Exception("incorrect serialization data");
+            }
+            int32_t refbase = refer->skip(validator.refs());
+            /* checked up front, so a rejected fragment writes nothing */
+            if (refbase < 0 && validator.refuses() > 0) {
+                throw Php::Exception("Can't write a fragment with refs in simple mode");
+            }
+            int32_t classbase = (int32_t)fieldsref.size();
+            StringStream fragment(std::string(data, length));
+            writeRaw(fragment, fragment.getchar(), refbase, classbase);
+        }
         void serialize(const Php::Value &value) {
             switch (value.type()) {
                 case Php::Type::Null:
@@ -368,6 +516,9 @@ namespace Hprose {
                     else if (className == "HproseMap") {
                         writeMapWithRef(value);
                     }
+                    else if (traversable && value.instanceOf("Traversable")) {
+                        writeTraversableWithRef(value);
+                    }
                     else {
                         writeObjectWithRef(value);
                     }
@@ -386,6 +537,7 @@ namespace Hprose {
             if (params.size() > 1) {
                 simple = params[1];
             }
+            traversable = (params.size() > 2 && params[2]);
             init_refer(simple);
         }
         void serialize(Php::Parameters &params) {
@@ -464,6 +616,16 @@ namespace Hprose {
         void writeObjectWithRef(Php::Parameters &params) {
             writeObjectWithRef(params[0]);
         }
+        void writeTraversable(Php::Parameters &params) {
+            writeTraversable(params[0], params.size() > 1 && params[1]);
+        }
+        void writeTraversableWithRef(Php::Parameters &params) {
+            writeTraversableWithRef(params[0], params.size() > 1 && params[1]);
+        }
+        void writeRaw(Php::Parameters &params) {
+            if (!params[0].isString()) throw Php::Exception("writeRaw expects a string");
+            writeRaw(params[0].rawValue(), params[0].size());
+        }
     };
     inline void publish_writer(Php::Extension &ext) {
         Php::Class<Writer> c("HproseWriter");
@@ -471,7 +633,8 @@ namespace Hprose {
                  &Hprose::Writer::__construct,
                  {
                      Php::ByVal("stream", "HproseStringStream"),
-                     Php::ByVal("simple", Php::Type::Bool, false)
+                     Php::ByVal("simple", Php::Type::Bool, false),
+                     Php::ByVal("traversable", Php::Type::Bool, false)
                  })
         .method("serialize",
                 &Hprose::Writer::serialize,
@@ -583,6 +746,23 @@ namespace Hprose {
                 {
                     Php::ByVal("obj", Php::Type::Object)
                 })
+        .method("writeTraversable",
+                &Hprose::Writer::writeTraversable,
+                {
+                    Php::ByVal("iterator", "Traversable"),
+                    Php::ByVal("map", Php::Type::Bool, false)
+                })
+        .method("writeTraversableWithRef",
+                &Hprose::Writer::writeTraversableWithRef,
+                {
+                    Php::ByVal("iterator", "Traversable"),
+                    Php::ByVal("map", Php::Type::Bool, false)
+                })
+        .method("writeRaw",
+                &Hprose::Writer::writeRaw,
+                {
+                    Php::ByVal("fragment", Php::Type::String)
+                })
         .method("reset", &Hprose::Writer::reset);
         ext.add(std::move(c));
     }
@@ -0,0 +1,136 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * hprose/xxteafilter.h                                   *
+ *                                                        *
+ * hprose xxtea filter class for php-cpp.                 *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#ifndef HPROSE_XXTEAFILTER_H_
+#define HPROSE_XXTEAFILTER_H_
+
+#include <phpcpp.h>
+#include <string.h>
+
+namespace Hprose {
+
+    /*
+     * The XXTEA filter of the other hprose implementations: the data is
+     * taken as little endian 32 bit words, the plain text length is
+     * appended as one more word before encryption, and the key is the
+     * first 16 bytes of the given key, padded with zeros.
+     */
+    class XXTEAFilter : public NativeFilter {
+    private:
+        static const uint32_t delta = 0x9E3779B9;
+        uint32_t key[4];
+        static inline uint32_t load(const char *p) {
+            uint32_t v;
+            memcpy(&v, p, 4);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            v = __builtin_bswap32(v);
+#endif
+            return v;
+        }
+        static inline void store(char *p, uint32_t v) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            v = __builtin_bswap32(v);
+#endif
+            memcpy(p, &v, 4);
+        }
+        inline uint32_t mx(uint32_t sum, uint32_t y, uint32_t z, uint32_t p, uint32_t e) const {
+            return (((z >> 5) ^ (y << 2)) + ((y >> 3) ^ (z << 4))) ^ ((sum ^ y) + (key[(p & 3) ^ e] ^ z));
+        }
+        /* every step needs the word before it, so the rounds stay serial */
+        void encrypt(char *v, uint32_t count) const {
+            uint32_t n = count - 1;
+            uint32_t z = load(v + n * 4), y, sum = 0, e, p;
+            for (uint32_t q = 6 + 52 / count; q > 0; --q) {
+                sum += delta;
+                e = (sum >> 2) & 3;
+                for (p = 0; p < n; ++p) {
+                    y = load(v + (p + 1) * 4);
+                    z = load(v + p * 4) + mx(sum, y, z, p, e);
+                    store(v + p * 4, z);
+                }
+                y = load(v);
+                z = load(v + n * 4) + mx(sum, y, z, p, e);
+                store(v + n * 4, z);
+            }
+        }
+        void decrypt(char *v, uint32_t count) const {
+            uint32_t n = count - 1;
+            uint32_t z, y = load(v), e, p;
+            uint32_t sum = (6 + 52 / count) * delta;
+            while (sum != 0) {
+                e = (sum >> 2) & 3;
+                for (p = n; p > 0; --p) {
+                    z = load(v + (p - 1) * 4);
+                    y = load(v + p * 4) - mx(sum, y, z, p, e);
+                    store(v + p * 4, y);
+                }
+                z = load(v + n * 4);
+                y = load(v) - mx(sum, y, z, p, e);
+                store(v, y);
+                sum -= delta;
+            }
+        }
+    public:
+        XXTEAFilter() {
+            memset(key, 0, sizeof(key));
+        }
+        virtual ~XXTEAFilter() {}
+        void setKey(const char *data, size_t length) {
+            char buf[16] = { 0 };
+            memcpy(buf, data, length < 16 ? length : 16);
+            for (int32_t i = 0; i < 4; ++i) key[i] = load(buf + i * 4);
+        }
+        virtual void output(std::string &data) override {
+            if (data.empty()) return;
+            uint32_t length = (uint32_t)data.size();
+            uint32_t count = (length + 3) / 4 + 1;
+            data.resize(count * 4, '\0');
+            store(&data[(count - 1) * 4], length);
+            encrypt(&data[0], count);
+        }
+        virtual void input(std::string &data) override {
+            if (data.empty()) return;
+            data.resize((data.size() + 3) & ~(size_t)3, '\0');
+            uint32_t count = (uint32_t)(data.size() / 4);
+            if (count < 2) throw Php::Exception("incorrect xxtea data");
+            decrypt(&data[0], count);
+            uint32_t n = (count - 1) * 4;
+            uint32_t length = load(&data[n]);
+            if (length + 3 < n || length > n) throw Php::Exception("incorrect xxtea data");
+            data.resize(length);
+        }
+        // -----------------------------------------------------------
+        // for PHP
+        void __construct(Php::Parameters &params) {
+            if (!params[0].isString()) throw Php::Exception("key must be a string");
+            setKey(params[0].rawValue(), params[0].size());
+        }
+    };
+
+    inline void publish_xxteafilter(Php::Extension &ext, const Php::Interface &filter) {
+        Php::Class<XXTEAFilter> c("HproseXXTEAFilter");
+        c.method("__construct",
+                 &Hprose::XXTEAFilter::__construct,
+                 { Php::ByVal("key", Php::Type::String) });
+        ext.add(std::move(native_filter_methods(c, filter)));
+    }
+}
+
+#endif /* HPROSE_XXTEAFILTER_H_ */
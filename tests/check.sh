@@ -0,0 +1,11 @@
+#!/bin/sh
+# Syntax checks every translation unit against the PHP-CPP stand-in,
+# plain, with ZTS and with the optional compression filters.
+cd "$(dirname "$0")/.." || exit 1
+CXX=${CXX:-g++}
+for flags in "" "-DZTS" "-DHPROSE_WITH_LZ4 -DHPROSE_WITH_ZSTD -Itests/stub/compress"; do
+    for f in hprose/*.cpp; do
+        $CXX -std=c++11 -Wall -fsyntax-only -Itests/stub $flags "$f" || exit 1
+    done
+done
+echo "syntax ok"
@@ -0,0 +1,82 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * tests/compressfilter.cpp                               *
+ *                                                        *
+ * hprose LZ4 and zstd filter tests.                      *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#define HPROSE_WITH_LZ4
+#define HPROSE_WITH_ZSTD
+#include <chrono>
+#include <phpcpp.h>
+#include "hprose/filter.h"
+#include "hprose/compressfilter.h"
+#include "test.h"
+
+/* hprose replies shaped like the objects of a typical service */
+static std::string corpus(int count) {
+    std::string data = "Rc4\"User\"4{s2\"id\"s4\"name\"s5\"email\"s6\"active\"}";
+    for (int i = 0; i < count; ++i) {
+        data += "o0{i" + std::to_string(i) + ";s7\"user" + std::to_string(i % 1000) +
+                "\"s17\"user@example.com\"" + (i % 3 ? "t" : "f") + "}";
+    }
+    return data + "z";
+}
+
+static bool too_large(Hprose::NativeFilter &filter, std::string data) {
+    try {
+        filter.input(data);
+    }
+    catch (Php::Exception &e) {
+        return e.message() == "message too large";
+    }
+    return false;
+}
+
+static void roundtrip(const char *name, Hprose::NativeFilter &filter, const std::string &data) {
+    std::string packed = data;
+    auto start = std::chrono::steady_clock::now();
+    filter.output(packed);
+    auto middle = std::chrono::steady_clock::now();
+    std::string unpacked = packed;
+    filter.input(unpacked);
+    auto end = std::chrono::steady_clock::now();
+    CHECK(unpacked == data);
+    double mb = data.size() / 1048576.0;
+    std::printf("%s: ratio %.2f, compress %.0f MB/s, decompress %.0f MB/s\n", name,
+                (double)data.size() / packed.size(),
+                mb / std::chrono::duration<double>(middle - start).count(),
+                mb / std::chrono::duration<double>(end - middle).count());
+}
+
+int main() {
+    Php::ini_values()["hprose.max_message_size"] = "16777216";
+    Hprose::LZ4Filter lz4;
+    Hprose::ZstdFilter zstd;
+    std::string data = corpus(100000);
+    roundtrip("lz4", lz4, data);
+    roundtrip("zstd", zstd, data);
+
+    /* a small message declaring a large size is refused before unpacking */
+    std::string zeros(4 * 1024 * 1024, '\0');
+    std::string lz4zeros = zeros, zstdzeros = zeros;
+    lz4.output(lz4zeros);
+    zstd.output(zstdzeros);
+    Php::ini_values()["hprose.max_message_size"] = "1048576";
+    CHECK(too_large(lz4, lz4zeros));
+    CHECK(too_large(zstd, zstdzeros));
+    return TEST_RESULT();
+}
@@ -0,0 +1,193 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * tests/connection.cpp                                   *
+ *                                                        *
+ * hprose client connection tests.                        *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <phpcpp.h>
+#include "hprose/connection.h"
+#include "test.h"
+
+using namespace Hprose;
+
+static int accepts = 0;
+
+static int listen_on(int &port) {
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t size = sizeof(addr);
+    bind(s, (sockaddr *)&addr, size);
+    listen(s, 8);
+    getsockname(s, (sockaddr *)&addr, &size);
+    port = ntohs(addr.sin_port);
+    return s;
+}
+
+/*
+ * Echoes each body, answering with Content-Length and chunked replies
+ * in turn, and closes every connection after 3 replies, so that the
+ * client has to replace a pooled connection closed by the server.
+ */
+static void http_server(int s) {
+    for (int c; (c = accept(s, nullptr, nullptr)) >= 0;) {
+        ++accepts;
+        std::string buffer;
+        char chunk[4096];
+        for (int replies = 0; replies < 3;) {
+            ssize_t n = recv(c, chunk, sizeof(chunk), 0);
+            if (n <= 0) break;
+            buffer.append(chunk, n);
+            size_t head = buffer.find("\r\n\r\n");
+            if (head == std::string::npos) continue;
+            size_t length = atoi(buffer.c_str() + buffer.find("Content-Length: ") + 16);
+            if (buffer.size() < head + 4 + length) continue;
+            std::string body = buffer.substr(head + 4, length);
+            buffer.erase(0, head + 4 + length);
+            std::string reply = "HTTP/1.1 200 OK\r\n";
+            if (replies++ % 2 == 0) {
+                reply += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+            }
+            else {
+                char size[16];
+                snprintf(size, sizeof(size), "%zx", body.size() - 3);
+                reply += "Transfer-Encoding: chunked\r\n\r\n3\r\n" + body.substr(0, 3) + "\r\n" +
+                         size + "\r\n" + body.substr(3) + "\r\n0\r\n\r\n";
+            }
+            send(c, reply.data(), reply.size(), 0);
+        }
+        close(c);
+    }
+}
+
+/* echoes each length prefixed body */
+static void tcp_server(int s) {
+    for (int c; (c = accept(s, nullptr, nullptr)) >= 0;) {
+        for (;;) {
+            unsigned char head[4];
+            if (recv(c, head, 4, MSG_WAITALL) != 4) break;
+            uint32_t n = head[0] << 24 | head[1] << 16 | head[2] << 8 | head[3];
+            std::string reply((char *)head, 4);
+            reply.resize(4 + n);
+            if (recv(c, &reply[4], n, MSG_WAITALL) != (ssize_t)n) break;
+            send(c, reply.data(), reply.size(), 0);
+        }
+        close(c);
+    }
+}
+
+static std::string parse_chunked(const std::string &chunks) {
+    std::string buffer = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" + chunks;
+    ResponseParser parser(true);
+    std::string response;
+    bool keep = false;
+    try {
+        return parser.parse(buffer, true, response, keep) ? response : "incomplete";
+    }
+    catch (Php::Exception &e) {
+        return e.message();
+    }
+}
+
+static Clock::time_point after(int ms) {
+    return Clock::now() + std::chrono::milliseconds(ms);
+}
+
+int main() {
+    CHECK(parse_chunked("3\r\nabc\r\n0\r\n\r\n") == "abc");
+    CHECK(parse_chunked("3;ext=1\r\nabc\r\n0\r\n\r\n") == "abc");
+    CHECK(parse_chunked("A \r\n0123456789\r\n0\r\n\r\n") == "0123456789");
+    CHECK(parse_chunked("zz\r\nabc\r\n0\r\n\r\n") == "Wrong chunk size");
+    CHECK(parse_chunked("\r\nabc\r\n0\r\n\r\n") == "Wrong chunk size");
+    CHECK(parse_chunked("3x\r\nabc\r\n0\r\n\r\n") == "Wrong chunk size");
+    CHECK(parse_chunked("ffffffffffffffffff\r\nabc\r\n0\r\n\r\n") == "Wrong chunk size");
+    CHECK(parse_chunked("3\r\nabcd\r\n0\r\n\r\n") == "Wrong chunk data");
+
+    /* 20MB in 1500 byte reads is decoded without going over it again */
+    std::string wire = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n", expected;
+    for (int i = 0; i < 20000; ++i) {
+        std::string chunk(1000 + i % 7, (char)('a' + i % 26));
+        char size[16];
+        snprintf(size, sizeof(size), "%zx", chunk.size());
+        wire += size + ("\r\n" + chunk) + "\r\n";
+        expected += chunk;
+    }
+    wire += "0\r\n\r\n";
+    {
+        Clock::time_point start = Clock::now();
+        ResponseParser parser(true);
+        std::string buffer, response;
+        bool keep = false, done = false;
+        for (size_t offset = 0; offset < wire.size() && !done; offset += 1500) {
+            buffer.append(wire, offset, 1500);
+            done = parser.parse(buffer, false, response, keep);
+        }
+        CHECK(done && response == expected && keep);
+        std::printf("chunked: %zu bytes in %lld ms\n", wire.size(), (long long)
+                    std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+    }
+
+    Endpoint v6 = Endpoint::parse("http://[::1]:8080/x");
+    CHECK(v6.host == "::1" && v6.port == "8080" && v6.path == "/x");
+    CHECK(frame_request(v6, "z").find("\r\nHost: [::1]:8080\r\n") != std::string::npos);
+
+    int http_port, tcp_port;
+    int hs = listen_on(http_port), ts = listen_on(tcp_port);
+    std::thread(http_server, hs).detach();
+    std::thread(tcp_server, ts).detach();
+
+    Endpoint http = Endpoint::parse("http://127.0.0.1:" + std::to_string(http_port) + "/rpc");
+    for (int i = 0; i < 7; ++i) {
+        std::string body = "Cs3\"abc\"a1{i" + std::to_string(i) + ";}z";
+        CHECK(send_request(http, body, after(2000), true) == body);
+    }
+    /* 3 replies per connection, the pool reusing each one */
+    CHECK(accepts == 3);
+
+    Endpoint tcp = Endpoint::parse("tcp://127.0.0.1:" + std::to_string(tcp_port));
+    for (int i = 0; i < 5; ++i) {
+        std::string body(100000 + i, 'x');
+        CHECK(send_request(tcp, body, after(2000), true) == body);
+    }
+
+    bool refused = false;
+    try {
+        send_request(Endpoint::parse("tcp://127.0.0.1:1"), "x", after(200), true);
+    }
+    catch (Php::Exception &) {
+        refused = true;
+    }
+    CHECK(refused);
+
+    /* latency of small calls over pooled loopback connections */
+    std::vector<double> latencies;
+    std::string body = "Cs4\"echo\"a1{s5\"hello\"}z";
+    for (int i = 0; i < 2000; ++i) {
+        Clock::time_point start = Clock::now();
+        send_request(tcp, body, after(2000), true);
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("tcp loopback: p50 %.0f us, p99 %.0f us\n",
+                latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100]);
+    return TEST_RESULT();
+}
@@ -0,0 +1,12 @@
+#pragma once
+/* declarations of the library functions compressfilter.h uses, for check.sh */
+#define LZ4_MAX_INPUT_SIZE 0x7E000000
+typedef struct LZ4_stream_s LZ4_stream_t;
+int LZ4_compressBound(int);
+int LZ4_compress_default(const char*, char*, int, int);
+LZ4_stream_t* LZ4_createStream(void);
+int LZ4_freeStream(LZ4_stream_t*);
+int LZ4_loadDict(LZ4_stream_t*, const char*, int);
+int LZ4_compress_fast_continue(LZ4_stream_t*, const char*, char*, int, int, int);
+int LZ4_decompress_safe(const char*, char*, int, int);
+int LZ4_decompress_safe_usingDict(const char*, char*, int, int, const char*, int);
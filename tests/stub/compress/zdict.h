@@ -0,0 +1,5 @@
+#pragma once
+/* declarations of the library functions compressfilter.h uses, for check.sh */
+#include <stddef.h>
+size_t ZDICT_trainFromBuffer(void*, size_t, const void*, const size_t*, unsigned);
+unsigned ZDICT_isError(size_t); const char* ZDICT_getErrorName(size_t);
@@ -0,0 +1,17 @@
+#pragma once
+/* declarations of the library functions compressfilter.h uses, for check.sh */
+#include <stddef.h>
+#define ZSTD_CONTENTSIZE_UNKNOWN (0ULL - 1)
+#define ZSTD_CONTENTSIZE_ERROR   (0ULL - 2)
+typedef struct ZSTD_CCtx_s ZSTD_CCtx; typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+typedef struct ZSTD_CDict_s ZSTD_CDict; typedef struct ZSTD_DDict_s ZSTD_DDict;
+ZSTD_CCtx* ZSTD_createCCtx(void); size_t ZSTD_freeCCtx(ZSTD_CCtx*);
+ZSTD_DCtx* ZSTD_createDCtx(void); size_t ZSTD_freeDCtx(ZSTD_DCtx*);
+size_t ZSTD_compressCCtx(ZSTD_CCtx*, void*, size_t, const void*, size_t, int);
+ZSTD_CDict* ZSTD_createCDict(const void*, size_t, int); size_t ZSTD_freeCDict(ZSTD_CDict*);
+size_t ZSTD_compress_usingCDict(ZSTD_CCtx*, void*, size_t, const void*, size_t, const ZSTD_CDict*);
+ZSTD_DDict* ZSTD_createDDict(const void*, size_t); size_t ZSTD_freeDDict(ZSTD_DDict*);
+size_t ZSTD_decompress_usingDDict(ZSTD_DCtx*, void*, size_t, const void*, size_t, const ZSTD_DDict*);
+size_t ZSTD_decompressDCtx(ZSTD_DCtx*, void*, size_t, const void*, size_t);
+unsigned long long ZSTD_getFrameContentSize(const void*, size_t);
+size_t ZSTD_compressBound(size_t); unsigned ZSTD_isError(size_t); const char* ZSTD_getErrorName(size_t);
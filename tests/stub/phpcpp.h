@@ -0,0 +1,179 @@
+/*
+ * A stand-in for the PHP-CPP headers, declaring just what the hprose
+ * sources use, so that they can be syntax checked and the parts that
+ * don't need a PHP engine can be tested without PHP installed. Php::Value
+ * carries no value: every conversion gives 0, false or "", and every
+ * type check gives false. Ini settings are kept in Php::ini_values(),
+ * which a test can fill in.
+ */
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <functional>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <initializer_list>
+#include <strings.h>
+#define PHPCPP_EXPORT
+namespace Php {
+enum class Type { Null, Numeric, Float, Bool, Array, Object, String, Resource, Constant, ConstantArray, Callable, Reference };
+enum { Const = 1, Static = 2, Public = 4, Private = 8, Protected = 16 };
+class Value;
+class Base { public: virtual ~Base() {} Value __get(const Value &) const; void __set(const Value &, const Value &) const; bool __isset(const Value &) const; void __unset(const Value &) const; Value __call(const char *, std::vector<Value> &) const; };
+class Value {
+public:
+    Value() {}
+    Value(std::nullptr_t) {}
+    Value(bool) {}
+    Value(int16_t) {}
+    Value(long long) {}
+    Value(int32_t) {}
+    Value(int64_t) {}
+    Value(char) {}
+    Value(double) {}
+    Value(const char *) {}
+    Value(const char *, int) {}
+    Value(const std::string &) {}
+    Value(Type) {}
+    Value(const Base *) {}
+    Value(const Value &) {}
+    Value(Value &&) {}
+    template <typename T> Value(const std::vector<T> &) {}
+    template <typename T> Value(const std::map<std::string,T> &) {}
+    Value &operator=(const Value &) { return *this; }
+    Value &operator=(Value &&) { return *this; }
+    template <typename T> Value &operator=(const T &) { return *this; }
+    Type type() const { return Type::Null; }
+    int size() const { return 0; }
+    int length() const { return 0; }
+    int count() const { return 0; }
+    const char *rawValue() const { return ""; }
+    std::string stringValue() const { return ""; }
+    int64_t numericValue() const { return 0; }
+    double floatValue() const { return 0; }
+    bool boolValue() const { return false; }
+    bool isList() const { return false; }
+    bool isNull() const { return false; }
+    bool isString() const { return false; }
+    bool isArray() const { return false; }
+    bool isObject() const { return false; }
+    bool isCallable() const { return false; }
+    bool isNumeric() const { return false; }
+    bool isBool() const { return false; }
+    bool isFloat() const { return false; }
+    bool refequals(const Value &) const { return false; }
+    uint64_t id() const { return 0; }
+    size_t hash() const { return 0; }
+    std::string className() const { return ""; }
+    Base *implementation() const { return nullptr; }
+    Value get(int) const { return Value(); }
+    Value get(const char *, int = -1) const { return Value(); }
+    bool contains(const char *, int = -1) const { return false; }
+    Value get(const std::string &) const { return Value(); }
+    Value get(const Value &) const { return Value(); }
+    void set(int, const Value &) {}
+    void set(const char *, int, const Value &) {}
+    void set(const std::string &, const Value &) {}
+    void set(const Value &, const Value &) {}
+    void unset(int) {}
+    bool contains(const Value &) const { return false; }
+    bool contains(int) const { return false; }
+    bool contains(const std::string &) const { return false; }
+    std::vector<std::string> properties(bool) const { return {}; }
+    Value ref() const { return Value(); }
+    bool instanceOf(const char *) const { return false; }
+    bool instanceOf(const std::string &) const { return false; }
+    template <typename... Args> Value call(const char *, Args&&...) const { return Value(); }
+    template <typename... Args> Value operator()(Args&&...) const { return Value(); }
+    Value operator[](int) const { return Value(); }
+    Value operator[](const char *) const { return Value(); }
+    Value operator[](const std::string &) const { return Value(); }
+    bool operator==(const Value &) const { return false; }
+    bool operator!=(const Value &) const { return false; }
+    operator bool() const { return false; }
+    operator int32_t() const { return 0; }
+    operator int64_t() const { return 0; }
+    operator double() const { return 0; }
+    operator std::string() const { return ""; }
+    char *reserve(size_t) { static char b[1]; return b; }
+    bool operator==(int) const { return false; }
+    Value clone() const { return Value(); }
+    struct iterator { const std::pair<Value,Value> &operator*() const; const std::pair<Value,Value> *operator->() const { return &**this; } iterator &operator++() { return *this; } bool operator!=(const iterator &) const { return false; } bool operator==(const iterator &) const { return true; } };
+    struct Pair;
+    iterator begin() const { return iterator(); }
+    iterator end() const { return iterator(); }
+    template <typename T> operator std::vector<T>() const { return {}; }
+    template <typename K, typename T> operator std::map<K, T>() const { return {}; }
+};
+inline const std::pair<Value,Value> &Value::iterator::operator*() const { static std::pair<Value,Value> p; return p; }
+class Array : public Value { public: Array() {} Array(const Value &) {} using Value::operator=; template <typename T> Array(const std::vector<T> &) {} };
+class Object : public Value { public: template <typename... Args> Object(const char *, Args&&...) {} Object() {} Object(const Value &) {} };
+typedef std::vector<Value> Parameters;
+class Exception : public std::exception { std::string m; public: Exception(const std::string &s) : m(s) {} Exception(const char *s) : m(s) {} virtual const char *what() const noexcept { return m.c_str(); } virtual const std::string &message() const { return m; } };
+struct ByVal { ByVal(const char *, Type, bool = true, bool = false) {} ByVal(const char *, const char *, bool = true, bool = false) {} ByVal(const char *, const char *, bool , bool, bool) {}};
+struct ByRef { ByRef(const char *, Type, bool = true, bool = false) {} ByRef(const char *, const char *, bool = true, bool = false) {} };
+struct Argument { Argument(const ByVal &) {} Argument(const ByRef &) {} };
+typedef std::initializer_list<Argument> Arguments;
+class Interface { public: Interface(const char *) {} Interface &method(const char *, Arguments = {}) { return *this; } Interface &method(const char *, int, Arguments = {}) { return *this; } };
+template <typename T> class Class {
+public:
+    Class(const char *) {}
+#define M(SIG) Class &method(const char *, SIG, Arguments = {}, bool = false) { return *this; } Class &method(const char *, SIG, int, Arguments = {}, bool = false) { return *this; }
+    M(void (T::*)()) M(void (T::*)(Parameters &)) M(Value (T::*)()) M(Value (T::*)(Parameters &))
+    M(void (T::*)() const) M(void (T::*)(Parameters &) const) M(Value (T::*)() const) M(Value (T::*)(Parameters &) const)
+    M(void (*)()) M(void (*)(Parameters &)) M(Value (*)()) M(Value (*)(Parameters &))
+#undef M
+    Class &method(const char *, int) { return *this; }
+    template <typename V> Class &property(const char *, V, int = 0) { return *this; }
+    template <typename G, typename S> Class &property(const char *, G, S) { return *this; }
+    template <typename P> Class &extends(const Class<P> &) { return *this; }
+    Class &implements(const Interface &) { return *this; }
+};
+class Ini { public: template <typename V> Ini(const char *, V) {} };
+class Extension {
+public:
+    Extension(const char *, const char *) {}
+    Extension &add(const char *, void (*)(), Arguments = {}, bool = false) { return *this; }
+    Extension &add(const char *, void (*)(Parameters &), Arguments = {}, bool = false) { return *this; }
+    Extension &add(const char *, Value (*)(), Arguments = {}, bool = false) { return *this; }
+    Extension &add(const char *, Value (*)(Parameters &), Arguments = {}, bool = false) { return *this; }
+    template <typename T> Extension &add(Class<T> &&) { return *this; }
+    template <typename T> Extension &add(const Class<T> &) { return *this; }
+    Extension &add(Interface &&) { return *this; }
+    Extension &add(const Interface &) { return *this; }
+    Extension &add(Ini &&) { return *this; }
+    Extension &onStartup(const std::function<void()> &) { return *this; }
+    Extension &onShutdown(const std::function<void()> &) { return *this; }
+    Extension &onRequest(const std::function<void()> &) { return *this; }
+    Extension &onIdle(const std::function<void()> &) { return *this; }
+    operator void *() { return this; }
+};
+class Iterator { public: Iterator(Base *) {} virtual ~Iterator() {} virtual bool valid() = 0; virtual Value current() = 0; virtual Value key() = 0; virtual void next() = 0; virtual void rewind() = 0; };
+class Traversable { public: virtual ~Traversable() {} virtual Iterator *getIterator() = 0; };
+inline Value eval(const std::string &) { return Value(); }
+inline bool class_exists(const std::string &, bool = true) { return false; }
+inline bool is_callable(const Value &) { return false; }
+template <typename... Args> Value call(const char *, Args&&...) { return Value(); }
+inline std::map<std::string, std::string> &ini_values() { static std::map<std::string, std::string> values; return values; }
+struct IniValue {
+    std::string value;
+    int64_t numericValue() const { return strtoll(value.c_str(), nullptr, 10); }
+    bool boolValue() const { return value == "1" || strcasecmp(value.c_str(), "on") == 0; }
+    std::string stringValue() const { return value; }
+    operator std::string() const { return value; }
+};
+inline IniValue ini_get(const char *name) { auto iter = ini_values().find(name); return IniValue{ iter == ini_values().end() ? "" : iter->second }; }
+static std::ostream &out = std::cout;
+struct Super { Value operator[](const char *) { return Value(); } };
+extern Super SERVER;
+static std::ostream &warning = std::cerr;
+
+inline void echo(const std::string &) {}
+}
+
+namespace Php { inline Value Base::__get(const Value &) const { return Value(); } inline void Base::__set(const Value &, const Value &) const {} inline bool Base::__isset(const Value &) const { return false; } inline void Base::__unset(const Value &) const {} inline Value Base::__call(const char *, std::vector<Value> &) const { return Value(); } }
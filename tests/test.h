@@ -0,0 +1,38 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * tests/test.h                                           *
+ *                                                        *
+ * checks shared by the hprose tests.                     *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#ifndef HPROSE_TEST_H_
+#define HPROSE_TEST_H_
+
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+            ++failures; \
+        } \
+    } while (0)
+
+#define TEST_RESULT() (std::printf("%s\n", failures ? "FAILED" : "ok"), failures ? 1 : 0)
+
+#endif /* HPROSE_TEST_H_ */
@@ -0,0 +1,65 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * tests/validator.cpp                                    *
+ *                                                        *
+ * hprose request validation tests.                       *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#include <cstring>
+#include <phpcpp.h>
+#include "hprose/tags.h"
+#include "hprose/validator.h"
+#include "test.h"
+
+static bool request(const char *data) {
+    Hprose::Validator validator;
+    return validator.validate_request(data, strlen(data));
+}
+
+static bool value(const char *data) {
+    Hprose::Validator validator;
+    return validator.validate(data, strlen(data));
+}
+
+int main() {
+    CHECK(request("Cs3\"foo\"z"));
+    CHECK(request("Cs3\"foo\"a1{i1;}tz"));
+    CHECK(request("Cs3\"foo\"a1{i1;}Cu1a2{s1\"x\"r0;}z"));
+    CHECK(request("Cs3\"foo\"a1{r0;}z"));
+    CHECK(!request("Cs3\"foo\"a1{d;}z"));
+    CHECK(!request("Co5{"));
+    CHECK(!request("Cr0;z"));
+    CHECK(!request("Cs3\"foo\"a1{i1;}"));
+    CHECK(!request("Cs3\"foo\"a1{i1;}zz"));
+    /* references don't reach into an earlier call */
+    CHECK(!request("Cs1\"a\"a1{s1\"x\"}Cs1\"b\"a1{r1;}z"));
+
+    CHECK(value("d.5;"));
+    CHECK(value("d1.;"));
+    CHECK(value("d-1.5e+10;"));
+    CHECK(value("d1E5;"));
+    CHECK(!value("i-;"));
+    CHECK(!value("d+;"));
+    CHECK(!value("d.;"));
+    CHECK(!value("de;"));
+    CHECK(!value("d1e;"));
+    CHECK(!value("d1e+;"));
+    CHECK(!value("i1.0;"));
+    CHECK(!value("i;"));
+    CHECK(!value("Es1\"x\""));
+    CHECK(!value("a1{d;}"));
+    return TEST_RESULT();
+}
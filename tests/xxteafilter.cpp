@@ -0,0 +1,77 @@
+/**********************************************************\
+|                                                          |
+|                          hprose                          |
+|                                                          |
+| Official WebSite: http://www.hprose.com/                 |
+|                   http://www.hprose.org/                 |
+|                                                          |
+\**********************************************************/
+
+/**********************************************************\
+ *                                                        *
+ * tests/xxteafilter.cpp                                  *
+ *                                                        *
+ * hprose XXTEA filter tests.                             *
+ *                                                        *
+ * LastModified: Oct 19, 2026                             *
+ * Author: Ma Bingyao <andot@hprose.com>                  *
+ *                                                        *
+\**********************************************************/
+
+#include <chrono>
+#include <phpcpp.h>
+#include "hprose/filter.h"
+#include "hprose/xxteafilter.h"
+#include "test.h"
+
+static std::string base64(const std::string &data) {
+    static const char *table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string result;
+    size_t i = 0;
+    for (; i + 2 < data.size(); i += 3) {
+        uint32_t v = (uint8_t)data[i] << 16 | (uint8_t)data[i + 1] << 8 | (uint8_t)data[i + 2];
+        result.append(1, table[v >> 18]).append(1, table[v >> 12 & 63])
+              .append(1, table[v >> 6 & 63]).append(1, table[v & 63]);
+    }
+    if (i < data.size()) {
+        uint32_t v = (uint8_t)data[i] << 16;
+        if (i + 1 < data.size()) v |= (uint8_t)data[i + 1] << 8;
+        result.append(1, table[v >> 18]).append(1, table[v >> 12 & 63])
+              .append(1, i + 1 < data.size() ? table[v >> 6 & 63] : '=').append(1, '=');
+    }
+    return result;
+}
+
+int main() {
+    Hprose::XXTEAFilter filter;
+    filter.setKey("1234567890", 10);
+
+    /* the test vector of the other xxtea implementations */
+    std::string data = "Hello World! \xe4\xbd\xa0\xe5\xa5\xbd\xef\xbc\x8c\xe4\xb8\xad\xe5\x9b\xbd\xef\xbc\x81";
+    std::string encrypted = data;
+    filter.output(encrypted);
+    CHECK(base64(encrypted) == "QncB1C0rHQoZ1eRiPM4dsZtRi9pNrp7sqvX76cFXvrrIHXL6");
+    filter.input(encrypted);
+    CHECK(encrypted == data);
+
+    for (int n = 1; n < 100; ++n) {
+        std::string s(n, '\0');
+        for (int i = 0; i < n; ++i) s[i] = (char)(i * 7);
+        std::string t = s;
+        filter.output(t);
+        filter.input(t);
+        CHECK(t == s);
+    }
+
+    std::string large(16 * 1024 * 1024, 'x');
+    auto start = std::chrono::steady_clock::now();
+    filter.output(large);
+    auto middle = std::chrono::steady_clock::now();
+    filter.input(large);
+    auto end = std::chrono::steady_clock::now();
+    CHECK(large == std::string(16 * 1024 * 1024, 'x'));
+    std::printf("xxtea: encrypt %.0f MB/s, decrypt %.0f MB/s\n",
+                16 / std::chrono::duration<double>(middle - start).count(),
+                16 / std::chrono::duration<double>(end - middle).count());
+    return TEST_RESULT();
+}